@@ -0,0 +1,208 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ExtrusionEntityCollection.hpp>
+#include <libslic3r/Geometry.hpp>
+#include <libslic3r/PolylineCollection.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: chainedpath [max_number_of_segments] [max_number_of_segments_for_the_linear_search]"
+};
+
+using namespace Slic3r;
+
+// Segments of the random gap fill: short segments of random directions over a 200x200mm area.
+static Polylines gap_fill(size_t num_segments)
+{
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist_pos(0., 200.), dist_len(-1., 1.);
+    Polylines out;
+    for (size_t i = 0; i < num_segments; ++ i) {
+        Vec2d a(dist_pos(rng), dist_pos(rng));
+        Vec2d b = a + Vec2d(dist_len(rng), dist_len(rng));
+        out.emplace_back(Polyline(Point::new_scale(a(0), a(1)), Point::new_scale(b(0), b(1))));
+    }
+    return out;
+}
+
+// Rectilinear infill lines of patches of 5mm, the end points of the neighbor lines are at the same distance.
+static Polylines infill(size_t num_segments)
+{
+    Polylines out;
+    for (size_t i = 0; i < num_segments; ++ i) {
+        double x = 5.5 * double(i / 400);
+        double y = 0.45 * double(i % 400);
+        out.emplace_back(Polyline(Point::new_scale(x, y), Point::new_scale(x + 5., y)));
+    }
+    return out;
+}
+
+// The nearest neighbor walks over the end points as they were implemented with the linear search,
+// returning the pairs of <index, reversed>.
+static std::vector<size_t> chained_path_linear(const Points &points, Point start_near)
+{
+    PointConstPtrs my_points;
+    std::vector<size_t> indices, out;
+    for (size_t i = 0; i < points.size(); ++ i) {
+        my_points.push_back(&points[i]);
+        indices.push_back(i);
+    }
+    while (! my_points.empty()) {
+        size_t idx = size_t(start_near.nearest_point_index(my_points));
+        start_near = *my_points[idx];
+        out.push_back(indices[idx]);
+        my_points.erase(my_points.begin() + idx);
+        indices.erase(indices.begin() + idx);
+    }
+    return out;
+}
+
+static std::vector<std::pair<size_t, bool>> polylines_chained_path_linear(const Polylines &src, Point start_near, bool no_reverse)
+{
+    std::vector<size_t> items;
+    for (size_t i = 0; i < src.size(); ++ i)
+        items.push_back(i);
+    std::vector<std::pair<size_t, bool>> out;
+    while (! items.empty()) {
+        double dmin = std::numeric_limits<double>::max();
+        size_t idx = 0;
+        for (size_t i = 0; i < items.size() && dmin >= EPSILON; ++ i)
+            for (int j = 0; j < (no_reverse ? 1 : 2) && dmin >= EPSILON; ++ j) {
+                const Point &p = j ? src[items[i]].last_point() : src[items[i]].first_point();
+                double d = sqr(double(start_near(0) - p(0))) + sqr(double(start_near(1) - p(1)));
+                if (d < dmin) {
+                    dmin = d;
+                    idx  = i * 2 + j;
+                }
+            }
+        out.emplace_back(items[idx / 2], (idx & 1) != 0);
+        const Polyline &pl = src[items[idx / 2]];
+        start_near = (idx & 1) ? pl.first_point() : pl.last_point();
+        items.erase(items.begin() + idx / 2);
+    }
+    return out;
+}
+
+static std::vector<std::pair<size_t, bool>> extrusions_chained_path_linear(const Polylines &src, Point start_near)
+{
+    Points endpoints;
+    std::vector<size_t> items;
+    for (size_t i = 0; i < src.size(); ++ i) {
+        endpoints.push_back(src[i].first_point());
+        endpoints.push_back(src[i].last_point());
+        items.push_back(i);
+    }
+    std::vector<std::pair<size_t, bool>> out;
+    while (! items.empty()) {
+        size_t idx = size_t(start_near.nearest_point_index(endpoints));
+        out.emplace_back(items[idx / 2], (idx & 1) != 0);
+        start_near = endpoints[idx ^ 1];
+        items.erase(items.begin() + idx / 2);
+        endpoints.erase(endpoints.begin() + (idx / 2) * 2, endpoints.begin() + (idx / 2) * 2 + 2);
+    }
+    return out;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if ((argc > 1 && std::atol(argv[1]) <= 0) || (argc > 2 && std::atol(argv[2]) < 0)) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t max_segments        = (argc > 1) ? size_t(std::atol(argv[1])) : 100000;
+    size_t max_segments_linear = (argc > 2) ? size_t(std::atol(argv[2])) : 20000;
+
+    struct DataSet { const char *name; Polylines (*generate)(size_t); } data_sets[] = {
+        { "gap fill", gap_fill }, { "infill", infill }
+    };
+
+    bool same_order = true;
+    Benchmark bench;
+    cout << std::fixed << std::setprecision(3);
+    for (const DataSet &data_set : data_sets)
+        for (size_t num_segments = 1000; num_segments <= max_segments; num_segments *= 10) {
+            const Polylines polylines = data_set.generate(num_segments);
+            const Point     start(0, 0);
+            Points first_points;
+            ExtrusionEntityCollection extrusions;
+            for (const Polyline &pl : polylines) {
+                first_points.emplace_back(pl.first_point());
+                ExtrusionPath path(erGapFill);
+                path.polyline = pl;
+                extrusions.append(path);
+            }
+            const bool linear = num_segments <= max_segments_linear;
+
+            // Geometry::chained_path()
+            std::vector<Points::size_type> points_order;
+            bench.start();
+            Geometry::chained_path(first_points, points_order, start);
+            bench.stop();
+            double time_points = bench.getElapsedSec();
+            bench.start();
+            std::vector<size_t> points_order_linear = linear ? chained_path_linear(first_points, start) : std::vector<size_t>();
+            bench.stop();
+            double time_points_linear = bench.getElapsedSec();
+            if (linear && std::vector<size_t>(points_order.begin(), points_order.end()) != points_order_linear)
+                same_order = false;
+
+            // PolylineCollection::chained_path_from()
+            double time_polylines = 0., time_polylines_linear = 0.;
+            for (int no_reverse = 0; no_reverse < 2; ++ no_reverse) {
+                bench.start();
+                Polylines chained = PolylineCollection::chained_path_from(polylines, start, no_reverse != 0);
+                bench.stop();
+                time_polylines += bench.getElapsedSec();
+                if (! linear)
+                    continue;
+                bench.start();
+                std::vector<std::pair<size_t, bool>> order = polylines_chained_path_linear(polylines, start, no_reverse != 0);
+                bench.stop();
+                time_polylines_linear += bench.getElapsedSec();
+                for (size_t i = 0; i < order.size(); ++ i)
+                    if (chained[i].first_point() != (order[i].second ? polylines[order[i].first].last_point() : polylines[order[i].first].first_point()) ||
+                        chained[i].last_point()  != (order[i].second ? polylines[order[i].first].first_point() : polylines[order[i].first].last_point()))
+                        same_order = false;
+            }
+
+            // ExtrusionEntityCollection::chained_path_from()
+            ExtrusionEntityCollection chained;
+            std::vector<size_t> orig_indices;
+            bench.start();
+            extrusions.chained_path_from(start, &chained, false, erMixed, &orig_indices);
+            bench.stop();
+            double time_extrusions = bench.getElapsedSec();
+            bench.start();
+            std::vector<std::pair<size_t, bool>> order = linear ? extrusions_chained_path_linear(polylines, start) : std::vector<std::pair<size_t, bool>>();
+            bench.stop();
+            double time_extrusions_linear = bench.getElapsedSec();
+            for (size_t i = 0; i < order.size(); ++ i)
+                if (orig_indices[i] != order[i].first ||
+                    chained.entities[i]->first_point() != (order[i].second ? polylines[order[i].first].last_point() : polylines[order[i].first].first_point()))
+                    same_order = false;
+
+            cout << data_set.name << ", " << num_segments << " segments:" << endl;
+            cout << "    Geometry::chained_path():                     " << time_points * 1000. << " ms";
+            if (linear) cout << ", linear search " << time_points_linear * 1000. << " ms";
+            cout << endl << "    PolylineCollection::chained_path_from():      " << time_polylines * 500. << " ms";
+            if (linear) cout << ", linear search " << time_polylines_linear * 500. << " ms";
+            cout << endl << "    ExtrusionEntityCollection::chained_path_from(): " << time_extrusions * 1000. << " ms";
+            if (linear) cout << ", linear search " << time_extrusions_linear * 1000. << " ms";
+            cout << endl;
+        }
+
+    if (! same_order) {
+        cout << "The order differs from the linear search!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ClipperUtils.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: clipperconversion [number_of_holes_per_side] [number_of_layers]"
+};
+
+using namespace Slic3r;
+
+// A slice of a perforated plate: a 100x100mm square with round holes of 72 segments.
+static Polygons perforated_plate(int num_holes)
+{
+    Polygons out;
+    out.emplace_back(Polygon({ Point::new_scale(0., 0.), Point::new_scale(100., 0.), Point::new_scale(100., 100.), Point::new_scale(0., 100.) }));
+    double pitch = 100. / double(num_holes);
+    for (int i = 0; i < num_holes; ++ i)
+        for (int j = 0; j < num_holes; ++ j) {
+            Polygon hole;
+            for (int k = 72; k > 0; -- k) {
+                double a = 2. * PI * double(k) / 72.;
+                hole.points.emplace_back(Point::new_scale(pitch * (double(i) + 0.5 + 0.3 * cos(a)), pitch * (double(j) + 0.5 + 0.3 * sin(a))));
+            }
+            out.emplace_back(std::move(hole));
+        }
+    return out;
+}
+
+static size_t num_points(const Polygons &polygons)
+{
+    size_t n = 0;
+    for (const Polygon &polygon : polygons)
+        n += polygon.points.size();
+    return n;
+}
+
+static bool same_polygons(const Polygons &a, const Polygons &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++ i)
+        if (a[i].points != b[i].points)
+            return false;
+    return true;
+}
+
+// The operations as they were implemented before the Clipper read the Slic3r polygons directly:
+// The input is copied into ClipperLib::Paths and scaled in place for the offset.
+namespace legacy {
+    static size_t points_copied = 0;
+
+    static ClipperLib::Paths to_paths(const Polygons &polygons)
+    {
+        points_copied += num_points(polygons);
+        return Slic3rMultiPoints_to_ClipperPaths(polygons);
+    }
+
+    static void scale_paths(ClipperLib::Paths &paths)
+    {
+        for (ClipperLib::Path &path : paths)
+            for (ClipperLib::IntPoint &pt : path) {
+                pt.X <<= CLIPPER_OFFSET_POWER_OF_2;
+                pt.Y <<= CLIPPER_OFFSET_POWER_OF_2;
+            }
+    }
+
+    static Polygons offset(const Polygons &polygons, float delta)
+    {
+        return ClipperPaths_to_Slic3rPolygons(_offset(to_paths(polygons), ClipperLib::etClosedPolygon, delta, jtMiter, 3.));
+    }
+
+    static Polygons offset2(const Polygons &polygons, float delta1, float delta2)
+    {
+        ClipperLib::Paths input = to_paths(polygons);
+        scale_paths(input);
+        ClipperLib::ClipperOffset co;
+        co.MiterLimit = 3.;
+        float delta_scaled1 = delta1 * float(CLIPPER_OFFSET_SCALE);
+        float delta_scaled2 = delta2 * float(CLIPPER_OFFSET_SCALE);
+        co.ShortestEdgeLength = double(std::max(std::abs(delta_scaled1), std::abs(delta_scaled2)) * 0.005f);
+        ClipperLib::Paths output1, output2;
+        co.AddPaths(input, jtMiter, ClipperLib::etClosedPolygon);
+        co.Execute(output1, delta_scaled1);
+        co.Clear();
+        co.AddPaths(output1, jtMiter, ClipperLib::etClosedPolygon);
+        co.Execute(output2, delta_scaled2);
+        for (ClipperLib::Path &path : output2)
+            for (ClipperLib::IntPoint &pt : path) {
+                pt.X = (pt.X + CLIPPER_OFFSET_SCALE_ROUNDING_DELTA) >> CLIPPER_OFFSET_POWER_OF_2;
+                pt.Y = (pt.Y + CLIPPER_OFFSET_SCALE_ROUNDING_DELTA) >> CLIPPER_OFFSET_POWER_OF_2;
+            }
+        return ClipperPaths_to_Slic3rPolygons(output2);
+    }
+
+    static Polygons clipper(ClipperLib::ClipType clipType, const Polygons &subject, const Polygons &clip)
+    {
+        ClipperLib::Clipper clipper;
+        clipper.AddPaths(to_paths(subject), ClipperLib::ptSubject, true);
+        clipper.AddPaths(to_paths(clip),    ClipperLib::ptClip,    true);
+        ClipperLib::Paths output;
+        clipper.Execute(clipType, output, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+        return ClipperPaths_to_Slic3rPolygons(output);
+    }
+}
+
+// Perimeters and gaps of a slice, the chain of the operations of the PerimeterGenerator with the thin walls enabled.
+template<typename Offset, typename Offset2, typename ClipperOp>
+static Polygons perimeters(const Polygons &slice, int num_perimeters, Offset offset, Offset2 offset2, ClipperOp clipper)
+{
+    const float distance = float(scale_(0.45));
+    Polygons last = slice, gaps, loops;
+    for (int i = 0; i < num_perimeters; ++ i) {
+        Polygons offsets = offset2(last, - 1.5f * distance, 0.5f * distance);
+        append(gaps, clipper(ClipperLib::ctDifference, offset(last, - 0.5f * distance), offset(offsets, 0.5f * distance + 10.f)));
+        append(loops, offsets);
+        last = std::move(offsets);
+    }
+    append(loops, gaps);
+    return clipper(ClipperLib::ctUnion, loops, Polygons());
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if ((argc > 1 && std::atol(argv[1]) <= 0) || (argc > 2 && std::atol(argv[2]) <= 0)) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    int num_holes  = (argc > 1) ? std::atoi(argv[1]) : 20;
+    int num_layers = (argc > 2) ? std::atoi(argv[2]) : 20;
+
+    const Polygons slice = perforated_plate(num_holes);
+    Benchmark bench;
+
+    Polygons result;
+    bench.start();
+    for (int i = 0; i < num_layers; ++ i)
+        result = perimeters(slice, 3,
+            [](const Polygons &polygons, float delta) { return offset(polygons, delta); },
+            [](const Polygons &polygons, float delta1, float delta2) { return offset2(polygons, delta1, delta2); },
+            [](ClipperLib::ClipType clipType, const Polygons &subject, const Polygons &clip) { return _clipper(clipType, subject, clip); });
+    bench.stop();
+    double time_direct = bench.getElapsedSec();
+
+    Polygons result_legacy;
+    bench.start();
+    for (int i = 0; i < num_layers; ++ i)
+        result_legacy = perimeters(slice, 3, legacy::offset, legacy::offset2, legacy::clipper);
+    bench.stop();
+    double time_legacy = bench.getElapsedSec();
+
+    cout << std::fixed << std::setprecision(3);
+    cout << "Slice of " << slice.size() << " polygons, " << num_points(slice) << " points, " << num_layers << " layers of 3 perimeters:" << endl;
+    cout << "    Clipper reading the Slic3r polygons: " << time_direct * 1000. / num_layers << " ms per layer" << endl;
+    cout << "    Converted to ClipperLib::Paths:      " << time_legacy * 1000. / num_layers << " ms per layer, " <<
+        legacy::points_copied / num_layers << " points copied per layer" << endl;
+
+    if (! same_polygons(result, result_legacy)) {
+        cout << "The results differ!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
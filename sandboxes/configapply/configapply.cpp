@@ -0,0 +1,113 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/Print.hpp>
+#include <libslic3r/PrintConfig.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: configapply [number_of_objects] [number_of_modifiers_per_object]"
+};
+
+using namespace Slic3r;
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if ((argc > 1 && std::atol(argv[1]) <= 0) || (argc > 2 && std::atol(argv[2]) < 0)) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    int num_objects   = (argc > 1) ? std::atoi(argv[1]) : 200;
+    int num_modifiers = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+    // A plate of small cubes, each with modifiers of one of 8 infill densities.
+    Model model;
+    for (int i = 0; i < num_objects; ++ i) {
+        ModelObject *object = model.add_object();
+        object->add_volume(make_cube(5., 5., 5.));
+        for (int j = 0; j < num_modifiers; ++ j) {
+            ModelVolume *modifier = object->add_volume(make_cube(2., 2., 2.));
+            modifier->set_type(ModelVolumeType::PARAMETER_MODIFIER);
+            modifier->config.set_deserialize("fill_density", std::to_string(10 + 5 * ((i + j) % 8)) + "%");
+        }
+        object->add_instance()->set_offset(Vec3d(10. * (i % 20), 10. * (i / 20), 0.));
+    }
+    DynamicPrintConfig config;
+    config.apply(FullPrintConfig());
+
+    Print print;
+    print.set_status_silent();
+    Benchmark bench;
+    bench.start();
+    print.apply(model, config);
+    bench.stop();
+    double time_first = bench.getElapsedSec();
+
+    // Print::apply() is called by the user interface on every change. Nothing changed.
+    const int num_repeats = 20;
+    bench.start();
+    for (int i = 0; i < num_repeats; ++ i)
+        print.apply(model, config);
+    bench.stop();
+    double time_unchanged = bench.getElapsedSec() / num_repeats;
+
+    // A region option changed, all the regions are compared and updated.
+    bench.start();
+    for (int i = 0; i < num_repeats; ++ i) {
+        config.set_deserialize("perimeter_speed", (i & 1) ? "60" : "45");
+        print.apply(model, config);
+    }
+    bench.stop();
+    double time_changed = bench.getElapsedSec() / num_repeats;
+
+    // Comparison of all pairs of the region configs by ConfigBase::diff() over the option names
+    // and by PrintRegionConfig::diff() over the option offsets.
+    const PrintRegionPtrs &regions = print.regions();
+    const int num_compares = 200;
+    bool same = true;
+    size_t num_diffs_names = 0, num_diffs_offsets = 0;
+    bench.start();
+    for (int k = 0; k < num_compares; ++ k)
+        for (const PrintRegion *r1 : regions)
+            for (const PrintRegion *r2 : regions)
+                num_diffs_names += static_cast<const ConfigBase&>(r1->config()).diff(r2->config()).size();
+    bench.stop();
+    double time_names = bench.getElapsedSec();
+    bench.start();
+    for (int k = 0; k < num_compares; ++ k)
+        for (const PrintRegion *r1 : regions)
+            for (const PrintRegion *r2 : regions)
+                num_diffs_offsets += r1->config().diff(r2->config()).size();
+    bench.stop();
+    double time_offsets = bench.getElapsedSec();
+    for (const PrintRegion *r1 : regions)
+        for (const PrintRegion *r2 : regions) {
+            bool equal = static_cast<const ConfigBase&>(r1->config()).equals(r2->config());
+            if (r1->config().diff(r2->config()) != static_cast<const ConfigBase&>(r1->config()).diff(r2->config()) ||
+                r1->config().equals(r2->config()) != equal ||
+                (equal && r1->config_hash() != r2->config_hash()) ||
+                r1->config_hash() != r1->config().hash())
+                same = false;
+        }
+
+    size_t num_pairs = regions.size() * regions.size() * num_compares;
+    cout << std::fixed << std::setprecision(3);
+    cout << num_objects << " objects, " << num_objects * num_modifiers << " modifiers, " << regions.size() << " regions:" << endl;
+    cout << "    Print::apply() first:            " << time_first * 1000. << " ms" << endl;
+    cout << "    Print::apply() unchanged:        " << time_unchanged * 1000. << " ms" << endl;
+    cout << "    Print::apply() region changed:   " << time_changed * 1000. << " ms" << endl;
+    cout << "    PrintRegionConfig diff by names:   " << time_names * 1e6 / num_pairs << " us" << endl;
+    cout << "    PrintRegionConfig diff by offsets: " << time_offsets * 1e6 / num_pairs << " us" << endl;
+
+    if (! same || num_diffs_names != num_diffs_offsets) {
+        cout << "The config comparisons differ!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/GCodeWriter.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: gcodewriter [number_of_moves]"
+};
+
+// The G1 extrusion line as it was formatted by GCodeWriter::extrude_to_xy() through std::ostringstream,
+// used as a reference for both the speed and the output.
+static std::string extrude_to_xy_ostream(const Slic3r::Vec2d &point, double E)
+{
+    std::ostringstream gcode;
+    gcode << "G1 X" << std::fixed << std::setprecision(3) << point(0)
+          <<   " Y" << std::fixed << std::setprecision(3) << point(1)
+          <<   " E" << std::fixed << std::setprecision(5) << E;
+    gcode << "\n";
+    return gcode.str();
+}
+
+int main(const int argc, const char *argv[]) {
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_moves = (argc > 1) ? size_t(std::atol(argv[1])) : 5000000;
+
+    // Short segments of a spiral over a 250x210 bed, roughly what the perimeters of a large print look like.
+    std::vector<Vec2d> points;
+    points.reserve(num_moves);
+    for (size_t i = 0; i < num_moves; ++ i) {
+        double a = 0.01 * double(i);
+        double r = 5. + 95. * double(i % 100000) / 100000.;
+        points.emplace_back(125. + r * cos(a), 105. + r * sin(a));
+    }
+    const double dE = 0.0123456;
+
+    Benchmark bench;
+    std::string gcode_ostream;
+    bench.start();
+    {
+        double E = 0.;
+        for (const Vec2d &pt : points) {
+            E += dE;
+            gcode_ostream += extrude_to_xy_ostream(pt, E);
+        }
+    }
+    bench.stop();
+    double time_ostream = bench.getElapsedSec();
+
+    GCodeWriter writer;
+    writer.set_extruders({ 0 });
+    writer.set_extruder(0);
+    std::string gcode_string;
+    bench.start();
+    for (const Vec2d &pt : points)
+        gcode_string += writer.extrude_to_xy(pt, dE);
+    bench.stop();
+    double time_string = bench.getElapsedSec();
+
+    writer.set_extruders({ 0 });
+    writer.set_extruder(0);
+    std::string gcode_append;
+    bench.start();
+    for (const Vec2d &pt : points)
+        writer.extrude_to_xy(gcode_append, pt, dE);
+    bench.stop();
+    double time_append = bench.getElapsedSec();
+
+    cout << std::fixed << std::setprecision(0);
+    cout << "std::ostringstream:           " << double(num_moves) / time_ostream << " moves/s" << endl;
+    cout << "GCodeWriter, returned string: " << double(num_moves) / time_string  << " moves/s" << endl;
+    cout << "GCodeWriter, appended:        " << double(num_moves) / time_append  << " moves/s" << endl;
+
+    if (gcode_ostream != gcode_string || gcode_ostream != gcode_append) {
+        cout << "The G-code differs from the std::ostringstream output!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
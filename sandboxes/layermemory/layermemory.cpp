@@ -0,0 +1,127 @@
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/Layer.hpp>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/PackedExPolygons.hpp>
+#include <libslic3r/Print.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: layermemory [number_of_pillars_per_side]"
+};
+
+using namespace Slic3r;
+
+// Heap usage of ExPolygons: the bytes of the vectors and the number of the allocations.
+static void memory_used(const ExPolygons &expolygons, size_t &bytes, size_t &allocations)
+{
+    bytes += expolygons.capacity() * sizeof(ExPolygon);
+    allocations += expolygons.capacity() > 0;
+    for (const ExPolygon &expoly : expolygons) {
+        bytes += expoly.holes.capacity() * sizeof(Polygon) + expoly.contour.points.capacity() * sizeof(Point);
+        allocations += (expoly.holes.capacity() > 0) + (expoly.contour.points.capacity() > 0);
+        for (const Polygon &hole : expoly.holes) {
+            bytes += hole.points.capacity() * sizeof(Point);
+            allocations += hole.points.capacity() > 0;
+        }
+    }
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    int num_pillars = (argc > 1) ? std::atoi(argv[1]) : 12;
+
+    // A grid of pillars and a sphere, the layers of the pillars consist of many small islands.
+    Model model;
+    {
+        TriangleMesh pillars;
+        for (int i = 0; i < num_pillars; ++ i)
+            for (int j = 0; j < num_pillars; ++ j) {
+                TriangleMesh pillar = make_cylinder(4., 40., 2. * PI / 36.);
+                pillar.translate(float(10 * i), float(10 * j), 0.f);
+                pillars.merge(pillar);
+            }
+        ModelObject *object = model.add_object();
+        object->add_volume(pillars);
+        object->add_instance()->set_offset(Vec3d(20., 20., 0.));
+        object = model.add_object();
+        TriangleMesh sphere = make_sphere(20., 2. * PI / 180.);
+        sphere.translate(0.f, 0.f, 20.f);
+        object->add_volume(sphere);
+        object->add_instance()->set_offset(Vec3d(200., 180., 0.));
+        for (ModelObject *o : model.objects)
+            o->ensure_on_bed();
+    }
+    DynamicPrintConfig config;
+    config.apply(FullPrintConfig());
+    config.set_deserialize("layer_height", "0.1");
+    Print print;
+    print.set_status_silent();
+    print.apply(model, config);
+    print.process();
+
+    size_t num_regions = 0;
+    size_t bytes_expolygons = 0, allocations_expolygons = 0;
+    size_t bytes_packed = 0, allocations_packed = 0;
+    double time_expolygons = 0., time_packed = 0., time_polygons_expolygons = 0., time_polygons_packed = 0.;
+    bool   same = true;
+    Benchmark bench;
+    for (const PrintObject *object : print.objects())
+        for (const Layer *layer : object->layers())
+            for (const LayerRegion *layerm : layer->regions()) {
+                // The fill boundaries in the form LayerRegion::fill_expolygons was stored before.
+                ExPolygons source = to_expolygons(layerm->fill_expolygons);
+                bench.start();
+                ExPolygons expolygons = source;
+                bench.stop();
+                time_expolygons += bench.getElapsedSec();
+                bench.start();
+                PackedExPolygons packed(source);
+                bench.stop();
+                time_packed += bench.getElapsedSec();
+                memory_used(expolygons, bytes_expolygons, allocations_expolygons);
+                bytes_packed += packed.memory_used();
+                allocations_packed += packed.empty() ? 0 : 3;
+                ++ num_regions;
+
+                bench.start();
+                Polygons polygons = to_polygons(expolygons);
+                bench.stop();
+                time_polygons_expolygons += bench.getElapsedSec();
+                bench.start();
+                Polygons polygons_packed = to_polygons(packed);
+                bench.stop();
+                time_polygons_packed += bench.getElapsedSec();
+                if (polygons.size() != polygons_packed.size())
+                    same = false;
+                else
+                    for (size_t i = 0; i < polygons.size(); ++ i)
+                        if (polygons[i].points != polygons_packed[i].points)
+                            same = false;
+            }
+
+    // glibc malloc adds 8 bytes to each allocation and rounds it up to 16 bytes, count 16 bytes per allocation.
+    const size_t overhead = 16;
+    cout << "Layer regions: " << num_regions << endl;
+    cout << std::fixed << std::setprecision(3);
+    cout << "LayerRegion::fill_expolygons as ExPolygons:       " << allocations_expolygons << " allocations, " <<
+        double(bytes_expolygons + overhead * allocations_expolygons) / 1048576. << " MB, copied in " << time_expolygons * 1000. << " ms, to_polygons() " << time_polygons_expolygons * 1000. << " ms" << endl;
+    cout << "LayerRegion::fill_expolygons as PackedExPolygons: " << allocations_packed << " allocations, " <<
+        double(bytes_packed + overhead * allocations_packed) / 1048576. << " MB, packed in " << time_packed * 1000. << " ms, to_polygons() " << time_polygons_packed * 1000. << " ms" << endl;
+
+    if (! same) {
+        cout << "The packed polygons differ!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
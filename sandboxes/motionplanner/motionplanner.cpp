@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/MotionPlanner.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: motionplanner [number_of_travel_moves]"
+};
+
+// A square plate with a grid of square holes, the worst case for the avoid_crossing_perimeters travel planning:
+// Most of the straight travel moves cross some of the holes.
+static Slic3r::ExPolygon perforated_plate(const Slic3r::Point &origin, double size, int num_holes)
+{
+    using namespace Slic3r;
+    ExPolygon plate;
+    const coord_t s = coord_t(scale_(size));
+    plate.contour.points = { origin, origin + Point(s, 0), origin + Point(s, s), origin + Point(0, s) };
+    const double pitch = size / double(num_holes);
+    const coord_t h = coord_t(scale_(0.5 * pitch));
+    for (int i = 0; i < num_holes; ++ i)
+        for (int j = 0; j < num_holes; ++ j) {
+            Point c = origin + Point(coord_t(scale_((i + 0.5) * pitch)), coord_t(scale_((j + 0.5) * pitch)));
+            // Holes are oriented clockwise.
+            Polygon hole;
+            hole.points = { c + Point(- h / 2, - h / 2), c + Point(- h / 2, h / 2), c + Point(h / 2, h / 2), c + Point(h / 2, - h / 2) };
+            plate.holes.emplace_back(std::move(hole));
+        }
+    return plate;
+}
+
+int main(const int argc, const char *argv[]) {
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_moves = (argc > 1) ? size_t(std::atol(argv[1])) : 2000;
+
+    // Two perforated plates next to each other, so that the travel moves between them are planned over the open space.
+    ExPolygons islands;
+    islands.emplace_back(perforated_plate(Point(0, 0), 100., 20));
+    islands.emplace_back(perforated_plate(Point(coord_t(scale_(110.)), 0), 100., 20));
+
+    // Random travel moves between points on the plates, outside of the holes.
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> dist_x(0., 210.), dist_y(0., 100.);
+    Points points;
+    while (points.size() < 2 * num_moves) {
+        Point pt = Point::new_scale(dist_x(rng), dist_y(rng));
+        if (islands.front().contains(pt) || islands.back().contains(pt))
+            points.emplace_back(pt);
+    }
+
+    Benchmark bench;
+    bench.start();
+    MotionPlanner mp(islands);
+    mp.initialize();
+    bench.stop();
+    double time_init = bench.getElapsedSec();
+
+    // The first travel moves create the graphs of the islands and of the open space.
+    double length = 0.;
+    bench.start();
+    for (size_t i = 0; i < points.size(); i += 2)
+        length += mp.shortest_path(points[i], points[i + 1]).length();
+    bench.stop();
+    double time_first = bench.getElapsedSec();
+
+    // Now all the graphs are cached.
+    bench.start();
+    for (size_t i = 0; i < points.size(); i += 2)
+        mp.shortest_path(points[i], points[i + 1]);
+    bench.stop();
+    double time_cached = bench.getElapsedSec();
+
+    // Compare the graph node lookup with the linear search.
+    MotionPlannerGraph graph;
+    Points nodes;
+    for (int i = 0; i < 20000; ++ i) {
+        nodes.emplace_back(Point::new_scale(dist_x(rng), dist_y(rng)));
+        graph.add_node(nodes.back());
+    }
+    graph.finalize();
+    bool lookup_ok = true;
+    size_t num_lookups = 0;
+    bench.start();
+    for (const Point &pt : points)
+        num_lookups += graph.find_closest_node(pt);
+    bench.stop();
+    double time_lookup = bench.getElapsedSec();
+    bench.start();
+    for (const Point &pt : points)
+        num_lookups -= size_t(pt.nearest_point_index(nodes));
+    bench.stop();
+    double time_lookup_linear = bench.getElapsedSec();
+    for (const Point &pt : points)
+        if (graph.find_closest_node(pt) != size_t(pt.nearest_point_index(nodes)))
+            lookup_ok = false;
+
+    cout << std::fixed << std::setprecision(3);
+    cout << "Configuration space:          " << time_init * 1000. << " ms" << endl;
+    cout << "Travel moves, creating graphs: " << time_first * 1000. << " ms for " << num_moves << " moves, total length " << unscale<double>(length) << " mm" << endl;
+    cout << "Travel moves, cached graphs:   " << time_cached * 1000. << " ms for " << num_moves << " moves" << endl;
+    cout << "Closest node, sorted by x:     " << time_lookup * 1000. << " ms for " << points.size() << " lookups" << endl;
+    cout << "Closest node, linear search:   " << time_lookup_linear * 1000. << " ms for " << points.size() << " lookups" << endl;
+
+    if (! lookup_ok || num_lookups != 0) {
+        cout << "The closest node differs from the linear search!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
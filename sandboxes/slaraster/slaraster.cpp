@@ -0,0 +1,114 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ExPolygon.hpp>
+#include <libslic3r/Rasterizer/Rasterizer.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: slaraster [number_of_layers]"
+};
+
+// An elliptic ring, the cross section of a hollow cylinder.
+static Slic3r::ExPolygon ring(double cx, double cy, double rx, double ry)
+{
+    using namespace Slic3r;
+    ExPolygon ring;
+    for (int i = 0; i < 360; ++ i) {
+        double a = 2. * PI * double(i) / 360.;
+        ring.contour.points.emplace_back(Point::new_scale(cx + rx * cos(a), cy + ry * sin(a)));
+    }
+    // Holes are oriented clockwise.
+    ring.holes.emplace_back();
+    for (int i = 359; i >= 0; -- i) {
+        double a = 2. * PI * double(i) / 360.;
+        ring.holes.back().points.emplace_back(Point::new_scale(cx + 0.5 * rx * cos(a), cy + 0.5 * ry * sin(a)));
+    }
+    return ring;
+}
+
+// Decode the run-length encoded TGA, return an empty string if it is malformed.
+static std::string decode_rle(const std::string &tga)
+{
+    std::string pixels;
+    if (tga.size() < 18 || tga[2] != 11)
+        return pixels;
+    for (size_t i = 18; i < tga.size();) {
+        size_t n = size_t(uint8_t(tga[i]) & 0x7F) + 1;
+        if (uint8_t(tga[i]) & 0x80) {
+            pixels.append(n, tga[i + 1]);
+            i += 2;
+        } else {
+            pixels.append(tga, i + 1, n);
+            i += n + 1;
+        }
+    }
+    return pixels;
+}
+
+int main(const int argc, const char *argv[]) {
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    int num_layers = (argc > 1) ? std::atoi(argv[1]) : 20;
+
+    // The display of the SL1 printer.
+    const unsigned w = 1440, h = 2560;
+    const Raster::PixelDim pixel_dim(68.04 / w, 120.96 / h);
+
+    // A plate of 12 hollow cylinders, a single large part and a layer above all the parts.
+    ExPolygons plate, dense, empty;
+    for (int i = 0; i < 3; ++ i)
+        for (int j = 0; j < 4; ++ j)
+            plate.emplace_back(ring(12. + 22. * i, 15. + 30. * j, 6., 6.));
+    dense.emplace_back(ring(34., 60., 30., 54.));
+    struct Layer { const char *name; const ExPolygons *islands; } layers[] = {
+        { "plate", &plate }, { "dense", &dense }, { "empty", &empty }
+    };
+    struct Format { const char *name; Raster::Compression compression; } formats[] = {
+        { "PNG", Raster::Compression::PNG }, { "RLE", Raster::Compression::RLE }, { "RAW", Raster::Compression::RAW }
+    };
+
+    bool rle_ok = true;
+    Benchmark bench;
+    cout << std::fixed << std::setprecision(1);
+    for (const Layer &layer : layers) {
+        Raster raster(Raster::Resolution(w, h), pixel_dim, Raster::Origin::TOP_LEFT);
+        for (const ExPolygon &island : *layer.islands)
+            raster.draw(island);
+        std::string raw, decoded;
+        for (const Format &format : formats) {
+            std::string out;
+            bench.start();
+            for (int i = 0; i < num_layers; ++ i) {
+                std::stringstream ss;
+                raster.save(ss, format.compression);
+                out = ss.str();
+            }
+            bench.stop();
+            cout << layer.name << ", " << format.name << ": " << double(num_layers) / bench.getElapsedSec() << " layers/s, " << out.size() << " bytes/layer" << endl;
+            if (format.compression == Raster::Compression::RAW)
+                raw = out.substr(out.size() - w * h);
+            else if (format.compression == Raster::Compression::RLE)
+                decoded = decode_rle(out);
+        }
+        if (decoded != raw)
+            rle_ok = false;
+    }
+
+    if (! rle_ok) {
+        cout << "The RLE output does not decode to the raster!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: stlconnect [number_of_facets]"
+};
+
+// Run stl_check_facets_exact() over the facets, return the time in seconds.
+static double check_facets_exact(stl_file &stl, int num_runs)
+{
+    Benchmark bench;
+    bench.start();
+    for (int i = 0; i < num_runs; ++ i)
+        stl_check_facets_exact(&stl);
+    bench.stop();
+    return bench.getElapsedSec() / double(num_runs);
+}
+
+int main(const int argc, const char *argv[]) {
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_facets = (argc > 1) ? size_t(std::atol(argv[1])) : 2000000;
+
+    // A sphere made of roughly num_facets facets, its facets are ordered by rings.
+    TriangleMesh mesh = make_sphere(100., 2. * PI * sqrt(2. / double(num_facets)));
+    stl_file &stl = mesh.stl;
+    cout << "Facets: " << stl.stats.number_of_facets << endl;
+
+    const int num_runs = 3;
+    double time_ordered = check_facets_exact(stl, num_runs);
+    int    connected_ordered = stl.stats.connected_edges;
+    int    collisions_ordered = stl.stats.collisions;
+
+    // Facets in a random order as they may come from a 3D scan, the edges are matched over the whole mesh.
+    std::shuffle(stl.facet_start, stl.facet_start + stl.stats.number_of_facets, std::mt19937(0));
+    double time_shuffled = check_facets_exact(stl, num_runs);
+    int    connected_shuffled = stl.stats.connected_edges;
+    int    collisions_shuffled = stl.stats.collisions;
+
+    cout << std::fixed << std::setprecision(0);
+    cout << "stl_check_facets_exact, ordered facets:  " << double(stl.stats.number_of_facets) / time_ordered  << " facets/s, " << collisions_ordered << " hash collisions" << endl;
+    cout << "stl_check_facets_exact, shuffled facets: " << double(stl.stats.number_of_facets) / time_shuffled << " facets/s, " << collisions_shuffled << " hash collisions" << endl;
+
+    if (connected_ordered != 3 * int(stl.stats.number_of_facets) || connected_shuffled != connected_ordered) {
+        cout << "Not all the edges were connected!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <boost/filesystem.hpp>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: stlload [number_of_facets]"
+};
+
+// Load the STL file, return the time in seconds.
+static double load_stl(const std::string &path, Slic3r::TriangleMesh &mesh)
+{
+    Benchmark bench;
+    bench.start();
+    mesh.ReadSTLFile(path.c_str());
+    bench.stop();
+    return bench.getElapsedSec();
+}
+
+// Are the vertices of the loaded mesh bitwise identical to the vertices of the source mesh?
+static bool same_vertices(const stl_file &a, const stl_file &b)
+{
+    if (a.error || b.error || a.stats.number_of_facets != b.stats.number_of_facets)
+        return false;
+    for (int i = 0; i < a.stats.number_of_facets; ++ i)
+        if (memcmp(a.facet_start[i].vertex, b.facet_start[i].vertex, sizeof(a.facet_start[i].vertex)) != 0)
+            return false;
+    return a.stats.min == b.stats.min && a.stats.max == b.stats.max;
+}
+
+int main(const int argc, const char *argv[]) {
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_facets = (argc > 1) ? size_t(std::atol(argv[1])) : 2000000;
+
+    TriangleMesh mesh = make_sphere(100., 2. * PI * sqrt(2. / double(num_facets)));
+    cout << "Facets: " << mesh.stl.stats.number_of_facets << endl;
+
+    boost::filesystem::path path_binary = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("stlload-%%%%-%%%%.stl");
+    boost::filesystem::path path_ascii  = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("stlload-%%%%-%%%%.stl");
+    mesh.write_binary(path_binary.string().c_str());
+    mesh.write_ascii(path_ascii.string().c_str());
+
+    TriangleMesh mesh_binary, mesh_ascii;
+    double time_binary = load_stl(path_binary.string(), mesh_binary);
+    double time_ascii  = load_stl(path_ascii.string(),  mesh_ascii);
+    double size_binary = double(boost::filesystem::file_size(path_binary)) / (1024. * 1024.);
+    double size_ascii  = double(boost::filesystem::file_size(path_ascii))  / (1024. * 1024.);
+    boost::filesystem::remove(path_binary);
+    boost::filesystem::remove(path_ascii);
+
+    cout << std::fixed << std::setprecision(1);
+    cout << "Binary STL: " << size_binary << " MB, " << time_binary * 1000. << " ms, " << size_binary / time_binary << " MB/s" << endl;
+    cout << "ASCII STL:  " << size_ascii  << " MB, " << time_ascii  * 1000. << " ms, " << size_ascii  / time_ascii  << " MB/s" << endl;
+
+    if (! same_vertices(mesh.stl, mesh_binary.stl) || ! same_vertices(mesh.stl, mesh_ascii.stl)) {
+        cout << "The loaded mesh differs from the saved one!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
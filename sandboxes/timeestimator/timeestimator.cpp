@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/GCodeTimeEstimator.hpp>
+#include <libnest2d/tools/benchmark.h>
+
+const std::string USAGE_STR = {
+    "Usage: timeestimator [number_of_moves]"
+};
+
+using namespace Slic3r;
+
+// Feeds the time estimator with a spiral vase made of short extrusions: No travels, no retractions and no st_synchronize,
+// and the segments are too short to reach the feed rate, so none of the blocks is planned with a nominal length.
+// Returns the largest memory used by the estimator while the moves were added.
+static size_t estimate_spiral_vase(size_t num_moves, float &time_estimate, double &time_elapsed)
+{
+    GCodeTimeEstimator estimator(GCodeTimeEstimator::Normal);
+    estimator.reset();
+    estimator.set_default();
+    // The interval of the remaining times exported by GCode.
+    estimator.set_remaining_times_interval(60.f);
+    estimator.add_gcode_line("G1 Z0.2 F7800");
+    estimator.add_gcode_line("G1 F2400");
+
+    // Segments of 0.1 mm on a circle of 20 mm radius, rising by 0.2 mm a turn.
+    const double radius          = 20.;
+    const double segment_length  = 0.1;
+    const size_t moves_per_turn  = size_t(std::ceil(2. * PI * radius / segment_length));
+    const double e_per_move      = 0.0045;
+    size_t       memory_max      = 0;
+    char         line[128];
+    Benchmark    bench;
+    bench.start();
+    for (size_t i = 0; i < num_moves; ++ i) {
+        double angle = 2. * PI * double(i % moves_per_turn) / double(moves_per_turn);
+        sprintf(line, "G1 X%.3f Y%.3f Z%.3f E%.5f", 100. + radius * cos(angle), 100. + radius * sin(angle),
+            0.2 + 0.2 * double(i) / double(moves_per_turn), e_per_move * double(i + 1));
+        estimator.add_gcode_line(line);
+        if ((i & 1023) == 0)
+            memory_max = std::max(memory_max, estimator.memory_used());
+    }
+    estimator.calculate_time();
+    bench.stop();
+    time_estimate = estimator.get_time();
+    time_elapsed  = bench.getElapsedSec();
+    return memory_max;
+}
+
+int main(const int argc, const char *argv[]) {
+    using std::cout; using std::endl;
+
+    if (argc > 1 && std::atol(argv[1]) <= 0) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+    size_t num_moves = (argc > 1) ? size_t(std::atol(argv[1])) : 1000000;
+
+    // The memory of the estimator shall not grow with the number of the moves, nor the time per move.
+    cout << std::fixed << std::setprecision(1);
+    size_t memory_first = 0;
+    size_t memory_last  = 0;
+    for (size_t n = num_moves / 10; n <= num_moves; n *= 10) {
+        float  time_estimate;
+        double time_elapsed;
+        size_t memory = estimate_spiral_vase(n, time_estimate, time_elapsed);
+        cout << n << " moves: estimated " << time_estimate << " s, max memory " << memory / 1024 << " kB, " <<
+            time_elapsed * 1e9 / double(n) << " ns per move" << endl;
+        if (memory_first == 0)
+            memory_first = memory;
+        memory_last = memory;
+    }
+
+    if (memory_last > 2 * memory_first) {
+        cout << "The planner window of the time estimator is not bounded!" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -43,11 +43,7 @@ static void stl_load_edge_exact(stl_file *stl, stl_hash_edge *edge,
                                 stl_vertex *a, stl_vertex *b);
 static int stl_load_edge_nearby(stl_file *stl, stl_hash_edge *edge,
                                 stl_vertex *a, stl_vertex *b, float tolerance);
-static void insert_hash_edge(stl_file *stl, stl_hash_edge edge,
-                             void (*match_neighbors)(stl_file *stl,
-                                 stl_hash_edge *edge_a, stl_hash_edge *edge_b));
 static int stl_compare_function(stl_hash_edge *edge_a, stl_hash_edge *edge_b);
-static void stl_free_edges(stl_file *stl);
 static void stl_remove_facet(stl_file *stl, int facet_number);
 static void stl_change_vertices(stl_file *stl, int facet_num, int vnot,
                                 stl_vertex new_vertex);
@@ -60,6 +56,77 @@ extern int stl_check_normal_vector(stl_file *stl,
                                    int facet_num, int normal_fix_flag);
 static void stl_update_connects_remove_1(stl_file *stl, int facet_num);
 
+static inline size_t hash_size_from_nr_faces(const size_t nr_faces)
+{
+	// Good primes for addressing a cca. 30 bit space.
+	// https://planetmath.org/goodhashtableprimes
+	static std::vector<uint32_t> primes{ 98317, 196613, 393241, 786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741 };
+	// Find a prime number for 50% filling of the shared triangle edges in the mesh.
+	auto it = std::upper_bound(primes.begin(), primes.end(), nr_faces * 3 * 2 - 1);
+	return (it == primes.end()) ? primes.back() : *it;
+}
+
+// Hash table of the edges waiting for their neighbor edge to be inserted.
+// The edges with the same hash are chained in the order of their insertion, so that an inserted edge is matched
+// with the first inserted edge of the same key. The chained edges are stored in a pool addressed by indices,
+// the slots of the matched edges are reused. This replaces a heap allocation per edge and it keeps the edges
+// packed in memory.
+class HashTableEdges
+{
+public:
+  typedef void (*MatchNeighbors)(stl_file *stl, stl_hash_edge *edge_a, stl_hash_edge *edge_b);
+
+  HashTableEdges(size_t nr_faces) : m_heads(hash_size_from_nr_faces(nr_faces), -1), m_free(-1) {}
+
+  void insert_edge(stl_file *stl, stl_hash_edge edge, MatchNeighbors match_neighbors)
+  {
+    if (stl->error)
+      return;
+
+    int chain_number = edge.hash(int(m_heads.size()));
+    // Index of the last edge visited in the chain, -1 if at the head of the chain.
+    int prev = -1;
+    for (int idx = m_heads[chain_number]; idx != -1; prev = idx, idx = m_pool[idx].next) {
+      if (! stl_compare_function(&edge, &m_pool[idx].edge)) {
+        // This is a match. Record result in neighbors list.
+        match_neighbors(stl, &edge, &m_pool[idx].edge);
+        // Delete the matched edge from the list, return its slot to the pool.
+        this->link(chain_number, prev) = m_pool[idx].next;
+        m_pool[idx].next = m_free;
+        m_free = idx;
+        ++ stl->stats.freed;
+        return;
+      }
+      ++ stl->stats.collisions;
+    }
+    // This is the last item in the list. Insert a new edge.
+    int idx = m_free;
+    if (idx == -1) {
+      idx = int(m_pool.size());
+      m_pool.emplace_back();
+    } else
+      m_free = m_pool[idx].next;
+    m_pool[idx].edge = edge;
+    m_pool[idx].next = -1;
+    this->link(chain_number, prev) = idx;
+    ++ stl->stats.malloced;
+  }
+
+private:
+  // Reference to the index of the edge following prev in a chain.
+  int& link(int chain_number, int prev) { return (prev == -1) ? m_heads[chain_number] : m_pool[prev].next; }
+
+  struct PoolEdge {
+    stl_hash_edge edge;
+    // Index of the next edge in a hash chain or in the list of free slots, -1 terminates the list.
+    int           next;
+  };
+  // Index of the first edge of each hash chain.
+  std::vector<int>      m_heads;
+  std::vector<PoolEdge> m_pool;
+  // Index of the first free slot in m_pool.
+  int                   m_free;
+};
 
 void
 stl_check_facets_exact(stl_file *stl) {
@@ -81,6 +148,7 @@ stl_check_facets_exact(stl_file *stl) {
   stl->stats.connected_facets_3_edge = 0;
 
   stl_initialize_facet_check_exact(stl);
+  HashTableEdges hash_table(stl->stats.number_of_facets);
 
   for(i = 0; i < stl->stats.number_of_facets; i++) {
     facet = stl->facet_start[i];
@@ -97,10 +165,9 @@ stl_check_facets_exact(stl_file *stl) {
       edge.facet_number = i;
       edge.which_edge = j;
       stl_load_edge_exact(stl, &edge, &facet.vertex[j], &facet.vertex[(j + 1) % 3]);
-      insert_hash_edge(stl, edge, stl_record_neighbors);
+      hash_table.insert_edge(stl, edge, stl_record_neighbors);
     }
   }
-  stl_free_edges(stl);
 
 #if 0
   printf("Number of faces: %d, number of manifold edges: %d, number of connected edges: %d, number of unconnected edges: %d\r\n", 
@@ -145,16 +212,6 @@ stl_load_edge_exact(stl_file *stl, stl_hash_edge *edge,
   }
 }
 
-static inline size_t hash_size_from_nr_faces(const size_t nr_faces)
-{
-	// Good primes for addressing a cca. 30 bit space.
-	// https://planetmath.org/goodhashtableprimes
-	static std::vector<uint32_t> primes{ 98317, 196613, 393241, 786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741 };
-	// Find a prime number for 50% filling of the shared triangle edges in the mesh.
-	auto it = std::upper_bound(primes.begin(), primes.end(), nr_faces * 3 * 2 - 1);
-	return (it == primes.end()) ? primes.back() : *it;
-}
-
 static void
 stl_initialize_facet_check_exact(stl_file *stl) {
   int i;
@@ -165,86 +222,12 @@ stl_initialize_facet_check_exact(stl_file *stl) {
   stl->stats.freed = 0;
   stl->stats.collisions = 0;
 
-  stl->M = hash_size_from_nr_faces(stl->stats.number_of_facets);
-
   for (i = 0; i < stl->stats.number_of_facets ; i++) {
     /* initialize neighbors list to -1 to mark unconnected edges */
     stl->neighbors_start[i].neighbor[0] = -1;
     stl->neighbors_start[i].neighbor[1] = -1;
     stl->neighbors_start[i].neighbor[2] = -1;
   }
-
-  stl->heads = (stl_hash_edge**)calloc(stl->M, sizeof(*stl->heads));
-  if(stl->heads == NULL) perror("stl_initialize_facet_check_exact");
-
-  stl->tail = (stl_hash_edge*)malloc(sizeof(stl_hash_edge));
-  if(stl->tail == NULL) perror("stl_initialize_facet_check_exact");
-
-  stl->tail->next = stl->tail;
-
-  for(i = 0; i < stl->M; i++) {
-    stl->heads[i] = stl->tail;
-  }
-}
-
-static void insert_hash_edge(stl_file *stl, stl_hash_edge edge,
-                 void (*match_neighbors)(stl_file *stl,
-                     stl_hash_edge *edge_a, stl_hash_edge *edge_b))
-{
-  if (stl->error) return;
-
-  int            chain_number = edge.hash(stl->M);
-  stl_hash_edge *link = stl->heads[chain_number];
-
-  stl_hash_edge *new_edge;
-  stl_hash_edge *temp;
-  if(link == stl->tail) {
-    /* This list doesn't have any edges currently in it.  Add this one. */
-    new_edge = (stl_hash_edge*)malloc(sizeof(stl_hash_edge));
-    if(new_edge == NULL) perror("insert_hash_edge");
-    stl->stats.malloced++;
-    *new_edge = edge;
-    new_edge->next = stl->tail;
-    stl->heads[chain_number] = new_edge;
-    return;
-  } else  if(!stl_compare_function(&edge, link)) {
-    /* This is a match.  Record result in neighbors list. */
-    match_neighbors(stl, &edge, link);
-    /* Delete the matched edge from the list. */
-    stl->heads[chain_number] = link->next;
-    free(link);
-    stl->stats.freed++;
-    return;
-  } else {
-    /* Continue through the rest of the list */
-    for(;;) {
-      if(link->next == stl->tail) {
-        /* This is the last item in the list. Insert a new edge. */
-        new_edge = (stl_hash_edge*)malloc(sizeof(stl_hash_edge));
-        if(new_edge == NULL) perror("insert_hash_edge");
-        stl->stats.malloced++;
-        *new_edge = edge;
-        new_edge->next = stl->tail;
-        link->next = new_edge;
-        stl->stats.collisions++;
-        return;
-      } else  if(!stl_compare_function(&edge, link->next)) {
-        /* This is a match.  Record result in neighbors list. */
-        match_neighbors(stl, &edge, link->next);
-
-        /* Delete the matched edge from the list. */
-        temp = link->next;
-        link->next = link->next->next;
-        free(temp);
-        stl->stats.freed++;
-        return;
-      } else {
-        /* This is not a match.  Go to the next link */
-        link = link->next;
-        stl->stats.collisions++;
-      }
-    }
-  }
 }
 
 // Return 1 if the edges are not matched.
@@ -267,6 +250,7 @@ void stl_check_facets_nearby(stl_file *stl, float tolerance)
   }
 
   stl_initialize_facet_check_nearby(stl);
+  HashTableEdges hash_table(stl->stats.number_of_facets);
 
   for (int i = 0; i < stl->stats.number_of_facets; ++ i) {
     //FIXME is the copy necessary?
@@ -280,13 +264,11 @@ void stl_check_facets_nearby(stl_file *stl, float tolerance)
                                 &facet.vertex[(j + 1) % 3],
                                 tolerance)) {
           /* only insert edges that have different keys */
-          insert_hash_edge(stl, edge, stl_match_neighbors_nearby);
+          hash_table.insert_edge(stl, edge, stl_match_neighbors_nearby);
         }
       }
     }
   }
-
-  stl_free_edges(stl);
 }
 
 static int stl_load_edge_nearby(stl_file *stl, stl_hash_edge *edge, stl_vertex *a, stl_vertex *b, float tolerance)
@@ -318,28 +300,8 @@ static int stl_load_edge_nearby(stl_file *stl, stl_hash_edge *edge, stl_vertex *
   return 1;
 }
 
-static void stl_free_edges(stl_file *stl)
-{
-  if (stl->error)
-    return;
-
-  if(stl->stats.malloced != stl->stats.freed) {
-    for (int i = 0; i < stl->M; i++) {
-      for (stl_hash_edge *temp = stl->heads[i]; stl->heads[i] != stl->tail; temp = stl->heads[i]) {
-        stl->heads[i] = stl->heads[i]->next;
-        free(temp);
-        ++ stl->stats.freed;
-      }
-    }
-  }
-  free(stl->heads);
-  free(stl->tail);
-}
-
 static void stl_initialize_facet_check_nearby(stl_file *stl)
 {
-  int i;
-
   if (stl->error) return;
 
   stl->stats.malloced = 0;
@@ -349,20 +311,6 @@ static void stl_initialize_facet_check_nearby(stl_file *stl)
   /*  tolerance = STL_MAX(stl->stats.shortest_edge, tolerance);*/
   /*  tolerance = STL_MAX((stl->stats.bounding_diameter / 500000.0), tolerance);*/
   /*  tolerance *= 0.5;*/
-
-  stl->M = hash_size_from_nr_faces(stl->stats.number_of_facets);
-
-  stl->heads = (stl_hash_edge**)calloc(stl->M, sizeof(*stl->heads));
-  if(stl->heads == NULL) perror("stl_initialize_facet_check_nearby");
-
-  stl->tail = (stl_hash_edge*)malloc(sizeof(stl_hash_edge));
-  if(stl->tail == NULL) perror("stl_initialize_facet_check_nearby");
-
-  stl->tail->next = stl->tail;
-
-  for(i = 0; i < stl->M; i++) {
-    stl->heads[i] = stl->tail;
-  }
 }
 
 
@@ -811,6 +759,7 @@ stl_fill_holes(stl_file *stl) {
 
   /* Insert all unconnected edges into hash list */
   stl_initialize_facet_check_nearby(stl);
+  HashTableEdges hash_table(stl->stats.number_of_facets);
   for(i = 0; i < stl->stats.number_of_facets; i++) {
     facet = stl->facet_start[i];
     for(j = 0; j < 3; j++) {
@@ -820,7 +769,7 @@ stl_fill_holes(stl_file *stl) {
       stl_load_edge_exact(stl, &edge, &facet.vertex[j],
                           &facet.vertex[(j + 1) % 3]);
 
-      insert_hash_edge(stl, edge, stl_record_neighbors);
+      hash_table.insert_edge(stl, edge, stl_record_neighbors);
     }
   }
 
@@ -876,7 +825,7 @@ stl_fill_holes(stl_file *stl) {
             stl_load_edge_exact(stl, &edge, &new_facet.vertex[k],
                                 &new_facet.vertex[(k + 1) % 3]);
 
-            insert_hash_edge(stl, edge, stl_record_neighbors);
+            hash_table.insert_edge(stl, edge, stl_record_neighbors);
           }
           break;
         } else {
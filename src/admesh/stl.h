@@ -69,13 +69,15 @@ typedef struct stl_hash_edge {
   // Compare two keys.
   bool operator==(const stl_hash_edge &rhs) { return memcmp(key, rhs.key, sizeof(key)) == 0; }
   bool operator!=(const stl_hash_edge &rhs) { return ! (*this == rhs); }
-  int  hash(int M) const { return ((key[0] / 11 + key[1] / 7 + key[2] / 3) ^ (key[3] / 11  + key[4] / 7 + key[5] / 3)) % M; }
+  // The two vertices of an edge are close to each other, therefore xoring their partial hashes cancels most of the bits
+  // and crowds the edges into a small part of the table. Adding them keeps the bits, dropping the lowest bits of the sum
+  // keeps the edges of the neighbor facets in the neighbor buckets, which are likely to be in the cache.
+  int  hash(int M) const { return int((((key[0] / 11 + key[1] / 7 + key[2] / 3) + (key[3] / 11  + key[4] / 7 + key[5] / 3)) >> 6) % uint32_t(M)); }
   // Index of a facet owning this edge.
   int            facet_number;
   // Index of this edge inside the facet with an index of facet_number.
   // If this edge is stored backwards, which_edge is increased by 3.
   int            which_edge;
-  struct stl_hash_edge  *next;
 } stl_hash_edge;
 
 typedef struct {
@@ -125,12 +127,8 @@ typedef struct {
 } stl_stats;
 
 typedef struct {
-  FILE          *fp;
   stl_facet     *facet_start;
   stl_edge      *edge_start;
-  stl_hash_edge **heads;
-  stl_hash_edge *tail;
-  int           M;
   stl_neighbors *neighbors_start;
   v_indices_struct *v_indices;
   stl_vertex    *v_shared;
@@ -200,9 +198,7 @@ extern void stl_calculate_volume(stl_file *stl);
 extern void stl_repair(stl_file *stl, int fixall_flag, int exact_flag, int tolerance_flag, float tolerance, int increment_flag, float increment, int nearby_flag, int iterations, int remove_unconnected_flag, int fill_holes_flag, int normal_directions_flag, int normal_values_flag, int reverse_all_flag, int verbose_flag);
 
 extern void stl_initialize(stl_file *stl);
-extern void stl_count_facets(stl_file *stl, const char *file);
 extern void stl_allocate(stl_file *stl);
-extern void stl_read(stl_file *stl, int first_facet, bool first);
 extern void stl_facet_stats(stl_file *stl, stl_facet facet, bool &first);
 extern void stl_reallocate(stl_file *stl);
 extern void stl_add_facet(stl_file *stl, stl_facet *new_facet);
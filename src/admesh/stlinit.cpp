@@ -26,22 +26,28 @@
 #include <math.h>
 #include <assert.h>
 
+#include <algorithm>
+#include <vector>
+
 #include <boost/nowide/cstdio.hpp>
 #include <boost/detail/endian.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include "stl.h"
 
 #ifndef SEEK_SET
 #error "SEEK_SET not defined"
 #endif
 
+static void stl_read(stl_file *stl, const char *file, bool first);
+
 void
 stl_open(stl_file *stl, const char *file) {
   stl_initialize(stl);
-  stl_count_facets(stl, file);
-  stl_allocate(stl);
-  stl_read(stl, 0, true);
-  if (!stl->error) fclose(stl->fp);
+  stl_read(stl, file, true);
+  if (!stl->error)
+    stl->stats.original_num_facets = stl->stats.number_of_facets;
 }
 
 
@@ -55,23 +61,209 @@ stl_initialize(stl_file *stl) {
 extern void stl_internal_reverse_quads(char *buf, size_t cnt);
 #endif /* BOOST_LITTLE_ENDIAN */
 
-void
-stl_count_facets(stl_file *stl, const char *file) {
-  long           file_size;
-  uint32_t       header_num_facets;
-  uint32_t       num_facets;
-  int            i;
-  size_t         s;
-  unsigned char  chtest[128];
-  int            num_lines = 1;
-  char           *error_msg;
+// Resize the arrays of facets and of their neighbors to hold facets_malloced facets, the new neighbors are zeroed.
+static bool stl_resize_facets(stl_file *stl, int facets_malloced)
+{
+  if (facets_malloced == 0)
+    // Keep the arrays, realloc() to zero bytes may return NULL.
+    return true;
+  stl_facet     *facets    = (stl_facet*)realloc(stl->facet_start, size_t(facets_malloced) * sizeof(stl_facet));
+  stl_neighbors *neighbors = (stl_neighbors*)realloc(stl->neighbors_start, size_t(facets_malloced) * sizeof(stl_neighbors));
+  if (facets != NULL)
+    stl->facet_start = facets;
+  if (neighbors != NULL)
+    stl->neighbors_start = neighbors;
+  if (facets == NULL || neighbors == NULL) {
+    perror("stl_read");
+    stl->error = 1;
+    return false;
+  }
+  if (facets_malloced > stl->stats.facets_malloced)
+    memset(neighbors + stl->stats.facets_malloced, 0, size_t(facets_malloced - stl->stats.facets_malloced) * sizeof(stl_neighbors));
+  stl->stats.facets_malloced = facets_malloced;
+  return true;
+}
+
+// Read num_facets facets of a binary STL file with a single fread() directly into the facet array.
+static void stl_read_binary(stl_file *stl, FILE *fp, int num_facets)
+{
+  int first_facet = stl->stats.number_of_facets;
+  if (! stl_resize_facets(stl, first_facet + num_facets))
+    return;
+  char *data = (char*)(stl->facet_start + first_facet);
+  if (fread(data, SIZEOF_STL_FACET, num_facets, fp) != size_t(num_facets)) {
+    stl->error = 1;
+    return;
+  }
+  // The facets are stored in the file as packed 50 bytes records, stl_facet is padded. Move the records to their slots
+  // starting from the last one, so that the records not moved yet are not overwritten.
+  if (sizeof(stl_facet) != SIZEOF_STL_FACET)
+    for (int i = num_facets - 1; i > 0; -- i)
+      memmove(data + size_t(i) * sizeof(stl_facet), data + size_t(i) * SIZEOF_STL_FACET, SIZEOF_STL_FACET);
+#ifndef BOOST_LITTLE_ENDIAN
+  // Convert the loaded little endian data to big endian.
+  for (int i = 0; i < num_facets; ++ i)
+    stl_internal_reverse_quads((char*)(stl->facet_start + first_facet + i), 48);
+#endif /* BOOST_LITTLE_ENDIAN */
+  stl->stats.number_of_facets += num_facets;
+}
+
+static inline bool stl_ascii_is_space(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+// Skip white spaces, then match a keyword and move p behind it.
+static inline bool stl_ascii_keyword(const char *&p, const char *end, const char *keyword)
+{
+  while (p != end && stl_ascii_is_space(*p))
+    ++ p;
+  for (; *keyword != 0; ++ p, ++ keyword)
+    if (p == end || *p != *keyword)
+      return false;
+  return true;
+}
+
+// Parse the ASCII STL facets of [begin, end) and append them to facets. Returns false on a syntax error.
+// The text is zero terminated behind the last facet, and a number is always followed by a keyword,
+// therefore strtof() never reads past the end of the text.
+static bool stl_parse_ascii_facets(const char *begin, const char *end, std::vector<stl_facet> &facets)
+{
+  stl_facet facet;
+  memset(&facet, 0, sizeof(facet));
+  for (const char *p = begin;;) {
+    // Skip the solid / endsolid lines, broken STL file generators may put several of them between the facets.
+    // The name of a solid may contain spaces or it may be empty.
+    for (;;) {
+      while (p != end && stl_ascii_is_space(*p))
+        ++ p;
+      if ((end - p >= 5 && strncmp(p, "solid", 5) == 0) || (end - p >= 8 && strncmp(p, "endsolid", 8) == 0))
+        p = std::find(p, end, '\n');
+      else
+        break;
+    }
+    if (p == end)
+      return true;
+    if (! stl_ascii_keyword(p, end, "facet") || ! stl_ascii_keyword(p, end, "normal"))
+      return false;
+    // The facet normal is parsed as a single token as a workaround for not a numbers in the normal definition.
+    bool normal_valid = true;
+    for (int i = 0; i < 3; ++ i) {
+      while (p != end && stl_ascii_is_space(*p))
+        ++ p;
+      const char *token_end = p;
+      while (token_end != end && ! stl_ascii_is_space(*token_end))
+        ++ token_end;
+      if (token_end == p)
+        return false;
+      char *number_end;
+      facet.normal(i) = strtof(p, &number_end);
+      if (number_end == p)
+        normal_valid = false;
+      p = token_end;
+    }
+    if (! normal_valid)
+      // Normal was mangled. Maybe denormals or "not a number" were stored?
+      // Just reset the normal and silently ignore it.
+      facet.normal = stl_normal::Zero();
+    if (! stl_ascii_keyword(p, end, "outer") || ! stl_ascii_keyword(p, end, "loop"))
+      return false;
+    for (int i = 0; i < 3; ++ i) {
+      if (! stl_ascii_keyword(p, end, "vertex"))
+        return false;
+      for (int j = 0; j < 3; ++ j) {
+        char *number_end;
+        facet.vertex[i](j) = strtof(p, &number_end);
+        if (number_end == p)
+          return false;
+        p = number_end;
+      }
+    }
+    if (! stl_ascii_keyword(p, end, "endloop") || ! stl_ascii_keyword(p, end, "endfacet"))
+      return false;
+    facets.emplace_back(facet);
+  }
+}
 
+// Read the facets of an ASCII STL file. The file is read by large blocks, the complete facets of a block are split
+// into chunks at the "endfacet" keywords and the chunks are parsed in parallel.
+static void stl_read_ascii(stl_file *stl, FILE *fp, size_t file_size)
+{
+  static const char  endfacet[] = "endfacet";
+  const size_t       endfacet_len = sizeof(endfacet) - 1;
+  const size_t       block_size   = std::min<size_t>(file_size, 64 * 1024 * 1024);
+  const size_t       chunk_size   = 1024 * 1024;
+  // One more byte for the terminating zero.
+  std::vector<char>  buffer(block_size + 1);
+  // Number of bytes of the buffer not parsed yet.
+  size_t             buffer_size = 0;
+  std::vector<const char*>             chunks;
+  std::vector<std::vector<stl_facet>>  chunk_facets;
+  for (bool eof = false; ! eof;) {
+    size_t num_read = fread(buffer.data() + buffer_size, 1, block_size - buffer_size, fp);
+    eof = buffer_size + num_read < block_size;
+    buffer_size += num_read;
+    buffer[buffer_size] = 0;
+    const char *begin = buffer.data();
+    const char *end   = begin + buffer_size;
+    if (! eof) {
+      // Parse up to the end of the last complete facet, the rest will be parsed together with the next block.
+      const char *last = std::find_end(begin, end, endfacet, endfacet + endfacet_len);
+      if (last == end) {
+        perror("Something is syntactically very wrong with this ASCII STL!");
+        stl->error = 1;
+        return;
+      }
+      end = last + endfacet_len;
+    }
+    chunks.assign(1, begin);
+    while (chunks.back() + chunk_size < end) {
+      const char *next = std::search(chunks.back() + chunk_size, end, endfacet, endfacet + endfacet_len);
+      if (next == end)
+        break;
+      chunks.emplace_back(next + endfacet_len);
+    }
+    if (chunks.back() != end)
+      chunks.emplace_back(end);
+    chunk_facets.assign(chunks.size() - 1, std::vector<stl_facet>());
+    std::vector<char> chunk_valid(chunk_facets.size(), false);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, chunk_facets.size()),
+      [&chunks, &chunk_facets, &chunk_valid](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i)
+          chunk_valid[i] = stl_parse_ascii_facets(chunks[i], chunks[i + 1], chunk_facets[i]);
+      });
+    if (std::find(chunk_valid.begin(), chunk_valid.end(), false) != chunk_valid.end()) {
+      perror("Something is syntactically very wrong with this ASCII STL!");
+      stl->error = 1;
+      return;
+    }
+    size_t num_facets = 0;
+    for (const std::vector<stl_facet> &facets : chunk_facets)
+      num_facets += facets.size();
+    if (stl->stats.number_of_facets + num_facets > size_t(stl->stats.facets_malloced) &&
+        ! stl_resize_facets(stl, int(std::max<size_t>(stl->stats.number_of_facets + num_facets, 2 * size_t(stl->stats.facets_malloced)))))
+      return;
+    for (const std::vector<stl_facet> &facets : chunk_facets) {
+      if (! facets.empty())
+        memcpy(stl->facet_start + stl->stats.number_of_facets, facets.data(), facets.size() * sizeof(stl_facet));
+      stl->stats.number_of_facets += int(facets.size());
+    }
+    // Move the incomplete facet at the end of the block to the start of the buffer.
+    buffer_size = buffer.data() + buffer_size - end;
+    memmove(buffer.data(), end, buffer_size);
+  }
+}
+
+/* Reads the contents of the STL file into the stl structure, appending the facets to the facets already loaded.
+   The last argument says if it's our first time running this for the stl and therefore we should reset our max
+   and min stats and read the header. */
+static void stl_read(stl_file *stl, const char *file, bool first) {
   if (stl->error) return;
 
-  /* Open the file in binary mode first */
-  stl->fp = boost::nowide::fopen(file, "rb");
-  if(stl->fp == NULL) {
-    error_msg = (char*)
+  /* Open the file in binary mode, the ASCII parser treats '\r' as a white space */
+  FILE *fp = boost::nowide::fopen(file, "rb");
+  if(fp == NULL) {
+    char *error_msg = (char*)
                 malloc(81 + strlen(file)); /* Allow 80 chars+file size for message */
     sprintf(error_msg, "stl_initialize: Couldn't open %s for reading",
             file);
@@ -81,96 +273,90 @@ stl_count_facets(stl_file *stl, const char *file) {
     return;
   }
   /* Find size of file */
-  fseek(stl->fp, 0, SEEK_END);
-  file_size = ftell(stl->fp);
+  fseek(fp, 0, SEEK_END);
+  long file_size = ftell(fp);
 
   /* Check for binary or ASCII file */
-  fseek(stl->fp, HEADER_SIZE, SEEK_SET);
-  if (!fread(chtest, sizeof(chtest), 1, stl->fp)) {
+  unsigned char chtest[128];
+  fseek(fp, HEADER_SIZE, SEEK_SET);
+  if (!fread(chtest, sizeof(chtest), 1, fp)) {
     perror("The input is an empty file");
     stl->error = 1;
+    fclose(fp);
     return;
   }
   stl->stats.type = ascii;
-  for(s = 0; s < sizeof(chtest); s++) {
+  for(size_t s = 0; s < sizeof(chtest); s++) {
     if(chtest[s] > 127) {
       stl->stats.type = binary;
       break;
     }
   }
-  rewind(stl->fp);
+  rewind(fp);
 
-  /* Get the header and the number of facets in the .STL file */
-  /* If the .STL file is binary, then do the following */
+  char header[LABEL_SIZE + 1];
+  memset(header, 0, sizeof(header));
+  int first_facet = stl->stats.number_of_facets;
   if(stl->stats.type == binary) {
     /* Test if the STL file has the right size  */
     if(((file_size - HEADER_SIZE) % SIZEOF_STL_FACET != 0)
         || (file_size < STL_MIN_FILE_SIZE)) {
       fprintf(stderr, "The file %s has the wrong size.\n", file);
       stl->error = 1;
+      fclose(fp);
       return;
     }
-    num_facets = (file_size - HEADER_SIZE) / SIZEOF_STL_FACET;
+    int num_facets = int((file_size - HEADER_SIZE) / SIZEOF_STL_FACET);
 
-    /* Read the header */
-    if (fread(stl->stats.header, LABEL_SIZE, 1, stl->fp) > 79) {
-      stl->stats.header[80] = '\0';
-    }
-
-    /* Read the int following the header.  This should contain # of facets */
-    bool header_num_faces_read = fread(&header_num_facets, sizeof(uint32_t), 1, stl->fp);
+    /* Read the header and the int following the header.  This should contain # of facets */
+    uint32_t header_num_facets;
+    bool header_num_faces_read = fread(header, LABEL_SIZE, 1, fp) && fread(&header_num_facets, sizeof(uint32_t), 1, fp);
 #ifndef BOOST_LITTLE_ENDIAN
     // Convert from little endian to big endian.
     stl_internal_reverse_quads((char*)&header_num_facets, 4);
 #endif /* BOOST_LITTLE_ENDIAN */
-    if (! header_num_faces_read || num_facets != header_num_facets) {
+    if (! header_num_faces_read || uint32_t(num_facets) != header_num_facets) {
       fprintf(stderr,
               "Warning: File size doesn't match number of facets in the header\n");
     }
+    stl_read_binary(stl, fp, num_facets);
+  } else {
+    /* Get the header, the first line of the file */
+    if (fgets(header, sizeof(header), fp) != NULL)
+      header[strcspn(header, "\r\n")] = '\0';
+    rewind(fp);
+    stl_read_ascii(stl, fp, size_t(file_size));
+    /* Release the memory allocated ahead by the parser */
+    if (!stl->error)
+      stl_resize_facets(stl, stl->stats.number_of_facets);
   }
-  /* Otherwise, if the .STL file is ASCII, then do the following */
-  else {
-    /* Reopen the file in text mode (for getting correct newlines on Windows) */
-    // fix to silence a warning about unused return value.
-    // obviously if it fails we have problems....
-    stl->fp = boost::nowide::freopen(file, "r", stl->fp);
-
-    // do another null check to be safe
-    if(stl->fp == NULL) {
-      error_msg = (char*)
-        malloc(81 + strlen(file)); /* Allow 80 chars+file size for message */
-      sprintf(error_msg, "stl_initialize: Couldn't open %s for reading",
-          file);
-      perror(error_msg);
-      free(error_msg);
-      stl->error = 1;
-      return;
-    }
-    
-    /* Find the number of facets */
-    char linebuf[100];
-    while (fgets(linebuf, 100, stl->fp) != NULL) {
-        /* don't count short lines */
-        if (strlen(linebuf) <= 4) continue;
-        
-        /* skip solid/endsolid lines as broken STL file generators may put several of them */
-        if (strncmp(linebuf, "solid", 5) == 0 || strncmp(linebuf, "endsolid", 8) == 0) continue;
-        
-        ++num_lines;
-    }
-    
-    rewind(stl->fp);
-    
-    /* Get the header */
-    for(i = 0;
-        (i < 80) && (stl->stats.header[i] = getc(stl->fp)) != '\n'; i++);
-    stl->stats.header[i] = '\0'; /* Lose the '\n' */
-    stl->stats.header[80] = '\0';
-
-    num_facets = num_lines / ASCII_LINES_PER_FACET;
-  }
-  stl->stats.number_of_facets += num_facets;
-  stl->stats.original_num_facets = stl->stats.number_of_facets;
+  fclose(fp);
+  if (stl->error) return;
+
+  if (first)
+    memcpy(stl->stats.header, header, sizeof(header));
+
+#if 0
+      // Report close to zero vertex coordinates. Due to the nature of the floating point numbers,
+      // close to zero values may be represented with singificantly higher precision than the rest of the vertices.
+      // It may be worth to round these numbers to zero during loading to reduce the number of errors reported
+      // during the STL import.
+      for (int i = first_facet; i < stl->stats.number_of_facets; ++ i)
+        for (size_t j = 0; j < 3; ++ j) {
+          const stl_facet &facet = stl->facet_start[i];
+          if (facet.vertex[j](0) > -1e-12f && facet.vertex[j](0) < 1e-12f)
+              printf("stl_read: facet %d(0) = %e\r\n", j, facet.vertex[j](0));
+          if (facet.vertex[j](1) > -1e-12f && facet.vertex[j](1) < 1e-12f)
+              printf("stl_read: facet %d(1) = %e\r\n", j, facet.vertex[j](1));
+          if (facet.vertex[j](2) > -1e-12f && facet.vertex[j](2) < 1e-12f)
+              printf("stl_read: facet %d(2) = %e\r\n", j, facet.vertex[j](2));
+        }
+#endif
+
+  for (int i = first_facet; i < stl->stats.number_of_facets; ++ i)
+    stl_facet_stats(stl, stl->facet_start[i], first);
+  stl->stats.size = stl->stats.max - stl->stats.min;
+  stl->stats.bounding_diameter = stl->stats.size.norm();
 }
 
 void
@@ -191,48 +377,19 @@ stl_allocate(stl_file *stl) {
 
 void
 stl_open_merge(stl_file *stl, char *file_to_merge) {
-  int num_facets_so_far;
-  stl_type origStlType;
-  FILE *origFp;
-  stl_file stl_to_merge;
-
   if (stl->error) return;
 
-  /* Record how many facets we have so far from the first file.  We will start putting
-     facets in the next position.  Since we're 0-indexed, it'l be the same position. */
-  num_facets_so_far = stl->stats.number_of_facets;
-
-  /* Record the file type we started with: */
-  origStlType=stl->stats.type;
-  /* Record the file pointer too: */
-  origFp=stl->fp;
-
-  /* Initialize the sturucture with zero stats, header info and sizes: */
-  stl_initialize(&stl_to_merge);
-  stl_count_facets(&stl_to_merge, file_to_merge);
-
-  /* Copy what we need to into stl so that we can read the file_to_merge directly into it
-     using stl_read:  Save the rest of the valuable info: */
-  stl->stats.type=stl_to_merge.stats.type;
-  stl->fp=stl_to_merge.fp;
-
-  /* Add the number of facets we already have in stl with what we we found in stl_to_merge but
-     haven't read yet. */
-  stl->stats.number_of_facets=num_facets_so_far+stl_to_merge.stats.number_of_facets;
-
-  /* Allocate enough room for stl->stats.number_of_facets facets and neighbors: */
-  stl_reallocate(stl);
+  /* Record the file type we started with, stl_read() overwrites it. */
+  stl_type origStlType = stl->stats.type;
 
-  /* Read the file to merge directly into stl, adding it to what we have already.
-     Start at num_facets_so_far, the index to the first unused facet.  Also say
+  /* Read the file to merge directly into stl, adding it to what we have already.  Also say
      that this isn't our first time so we should augment stats like min and max
      instead of erasing them. */
-  stl_read(stl, num_facets_so_far, false);
+  stl_read(stl, file_to_merge, false);
 
   /* Restore the stl information we overwrote (for stl_read) so that it still accurately
      reflects the subject part: */
-  stl->stats.type=origStlType;
-  stl->fp=origFp;
+  stl->stats.type = origStlType;
 }
 
 extern void
@@ -252,96 +409,6 @@ stl_reallocate(stl_file *stl) {
 }
 
 
-/* Reads the contents of the file pointed to by stl->fp into the stl structure,
-   starting at facet first_facet.  The second argument says if it's our first
-   time running this for the stl and therefore we should reset our max and min stats. */
-void stl_read(stl_file *stl, int first_facet, bool first) {
-  stl_facet facet;
-  int   i;
-
-  if (stl->error) return;
-
-  if(stl->stats.type == binary) {
-    fseek(stl->fp, HEADER_SIZE, SEEK_SET);
-  } else {
-    rewind(stl->fp);
-  }
-
-  char normal_buf[3][32];
-  for(i = first_facet; i < stl->stats.number_of_facets; i++) {
-    if(stl->stats.type == binary)
-      /* Read a single facet from a binary .STL file */
-    {
-      /* we assume little-endian architecture! */
-      if (fread(&facet, 1, SIZEOF_STL_FACET, stl->fp) != SIZEOF_STL_FACET) {
-        stl->error = 1;
-        return;
-      }
-#ifndef BOOST_LITTLE_ENDIAN
-      // Convert the loaded little endian data to big endian.
-      stl_internal_reverse_quads((char*)&facet, 48);
-#endif /* BOOST_LITTLE_ENDIAN */
-    } else
-      /* Read a single facet from an ASCII .STL file */
-    {
-      // skip solid/endsolid
-      // (in this order, otherwise it won't work when they are paired in the middle of a file)
-      fscanf(stl->fp, "endsolid%*[^\n]\n");
-      fscanf(stl->fp, "solid%*[^\n]\n");  // name might contain spaces so %*s doesn't work and it also can be empty (just "solid")
-      // Leading space in the fscanf format skips all leading white spaces including numerous new lines and tabs.
-      int res_normal     = fscanf(stl->fp, " facet normal %31s %31s %31s", normal_buf[0], normal_buf[1], normal_buf[2]);
-      assert(res_normal == 3);
-      int res_outer_loop = fscanf(stl->fp, " outer loop");
-      assert(res_outer_loop == 0);
-      int res_vertex1    = fscanf(stl->fp, " vertex %f %f %f", &facet.vertex[0](0), &facet.vertex[0](1), &facet.vertex[0](2));
-      assert(res_vertex1 == 3);
-      int res_vertex2    = fscanf(stl->fp, " vertex %f %f %f", &facet.vertex[1](0), &facet.vertex[1](1), &facet.vertex[1](2));
-      assert(res_vertex2 == 3);
-      int res_vertex3    = fscanf(stl->fp, " vertex %f %f %f", &facet.vertex[2](0), &facet.vertex[2](1), &facet.vertex[2](2));
-      assert(res_vertex3 == 3);
-      int res_endloop    = fscanf(stl->fp, " endloop");
-      assert(res_endloop == 0);
-      // There is a leading and trailing white space around endfacet to eat up all leading and trailing white spaces including numerous tabs and new lines.
-      int res_endfacet   = fscanf(stl->fp, " endfacet ");
-      if (res_normal != 3 || res_outer_loop != 0 || res_vertex1 != 3 || res_vertex2 != 3 || res_vertex3 != 3 || res_endloop != 0 || res_endfacet != 0) {
-        perror("Something is syntactically very wrong with this ASCII STL!");
-        stl->error = 1;
-        return;
-      }
-
-      // The facet normal has been parsed as a single string as to workaround for not a numbers in the normal definition.
-	  if (sscanf(normal_buf[0], "%f", &facet.normal(0)) != 1 ||
-		  sscanf(normal_buf[1], "%f", &facet.normal(1)) != 1 ||
-		  sscanf(normal_buf[2], "%f", &facet.normal(2)) != 1) {
-		  // Normal was mangled. Maybe denormals or "not a number" were stored?
-		  // Just reset the normal and silently ignore it.
-		  memset(&facet.normal, 0, sizeof(facet.normal));
-	  }
-    }
-
-#if 0
-      // Report close to zero vertex coordinates. Due to the nature of the floating point numbers,
-      // close to zero values may be represented with singificantly higher precision than the rest of the vertices.
-      // It may be worth to round these numbers to zero during loading to reduce the number of errors reported
-      // during the STL import.
-      for (size_t j = 0; j < 3; ++ j) {
-        if (facet.vertex[j](0) > -1e-12f && facet.vertex[j](0) < 1e-12f)
-            printf("stl_read: facet %d(0) = %e\r\n", j, facet.vertex[j](0));
-        if (facet.vertex[j](1) > -1e-12f && facet.vertex[j](1) < 1e-12f)
-            printf("stl_read: facet %d(1) = %e\r\n", j, facet.vertex[j](1));
-        if (facet.vertex[j](2) > -1e-12f && facet.vertex[j](2) < 1e-12f)
-            printf("stl_read: facet %d(2) = %e\r\n", j, facet.vertex[j](2));
-      }
-#endif
-
-    /* Write the facet into memory. */
-    stl->facet_start[i] = facet;
-    stl_facet_stats(stl, facet, first);
-  }
-  stl->stats.size = stl->stats.max - stl->stats.min;
-  stl->stats.bounding_diameter = stl->stats.size.norm();
-}
-
 void stl_facet_stats(stl_file *stl, stl_facet facet, bool &first)
 {
   if (stl->error)
@@ -284,10 +284,18 @@ enum EdgeSide { esLeft = 1, esRight = 2};
 class ClipperBase
 {
 public:
-  ClipperBase() : m_UseFullRange(false), m_HasOpenPaths(false) {}
+  ClipperBase() : m_UseFullRange(false), m_edgesUsed(0), m_HasOpenPaths(false) {}
   ~ClipperBase() { Clear(); }
-  bool AddPath(const Path &pg, PolyType PolyTyp, bool Closed);
-  bool AddPaths(const Paths &ppg, PolyType PolyTyp, bool Closed);
+  // Bytes of the buffers kept for the next operation, not counting the overhead of the allocator.
+  size_t BuffersSize() const;
+  // A path may be of any type providing size() and operator[] returning a point convertible to IntPoint,
+  // so that the paths of the application do not need to be copied into a Path just to be added to the Clipper.
+  template<typename PathT>
+  bool AddPath(const PathT &pg, PolyType PolyTyp, bool Closed);
+  template<typename PathsT>
+  bool AddPaths(const PathsT &ppg, PolyType PolyTyp, bool Closed);
+  // Remove the paths. The memory allocated for the edges is kept for the paths added next,
+  // so that an instance reused for many operations does not allocate its buffers over and over.
   void Clear();
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
@@ -295,7 +303,15 @@ public:
   bool PreserveCollinear() const {return m_PreserveCollinear;};
   void PreserveCollinear(bool value) {m_PreserveCollinear = value;};
 protected:
-  bool AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
+  // Index of the last point of a path after removing the duplicate points from its end, -1 if the path is degenerate.
+  template<typename PathT>
+  static int HighIndex(const PathT &pg, bool Closed);
+  // Build the edges of a path, the points of the path are passed in edges[0 .. highI].Curr.
+  bool AddPathInternal(int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
+  // An array of n edges, either reused from the paths removed by Clear() or newly allocated.
+  // It belongs to the Clipper once CommitEdges() is called.
+  std::vector<TEdge>& AllocateEdges(size_t n);
+  void CommitEdges() { ++ m_edgesUsed; }
   TEdge* AddBoundsToLML(TEdge *e, bool IsClosed);
   void Reset();
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
@@ -309,7 +325,9 @@ protected:
   // False if the input polygons have abs values lower or equal to loRange.
   bool              m_UseFullRange;
   // A vector of edges per each input path.
+  // Edges of the paths added are stored in m_edges[0 .. m_edgesUsed), the rest is kept for reuse.
   std::vector<std::vector<TEdge>> m_edges;
+  size_t           m_edgesUsed;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -321,8 +339,12 @@ class Clipper : public ClipperBase
 {
 public:
   Clipper(int initOptions = 0);
-  ~Clipper() { Clear(); }
+  ~Clipper();
+  // The output points and polygons are owned by the Clipper and kept between the operations.
+  Clipper(const Clipper &) = delete;
+  Clipper& operator=(const Clipper &) = delete;
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
+  size_t BuffersSize() const;
   bool Execute(ClipType clipType,
       Paths &solution,
       PolyFillType fillType = pftEvenOdd) 
@@ -354,8 +376,12 @@ private:
   
   // Output polygons.
   std::vector<OutRec*>  m_PolyOuts;
+  // Output polygons released by DisposeAllOutRecs(), to be reused by CreateOutRec().
+  std::vector<OutRec*>  m_OutRecsFree;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // The chunks m_OutPts[0 .. m_OutPtsChunksUsed) are in use, the rest is kept by DisposeAllOutRecs() for reuse.
   std::vector<OutPt*>   m_OutPts;
+  size_t                m_OutPtsChunksUsed;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkSize;
@@ -365,8 +391,12 @@ private:
   std::vector<Join>     m_GhostJoins;
   std::vector<IntersectNode> m_IntersectList;
   ClipType              m_ClipType;
-  // A priority queue (a binary heap) of Y coordinates.
-  std::priority_queue<cInt> m_Scanbeam;
+  // A priority queue (a binary heap) of Y coordinates, which keeps its memory when cleared.
+  struct Scanbeam : public std::priority_queue<cInt> {
+    void clear() { this->c.clear(); }
+    size_t capacity() const { return this->c.capacity(); }
+  };
+  Scanbeam              m_Scanbeam;
   // Maxima are collected by ProcessEdgesAtTopOfScanbeam(), consumed by ProcessHorizontal().
   std::vector<cInt>     m_Maxima;
   TEdge                *m_ActiveEdges;
@@ -442,11 +472,18 @@ public:
   ClipperOffset(double miterLimit = 2.0, double roundPrecision = 0.25, double shortestEdgeLength = 0.) :
     MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0) {}
   ~ClipperOffset() { Clear(); }
-  void AddPath(const Path& path, JoinType joinType, EndType endType);
-  void AddPaths(const Paths& paths, JoinType joinType, EndType endType);
+  // A path may be of any type providing size() and operator[] returning a point convertible to IntPoint,
+  // see ClipperBase::AddPath().
+  template<typename PathT>
+  void AddPath(const PathT& path, JoinType joinType, EndType endType);
+  template<typename PathsT>
+  void AddPaths(const PathsT& paths, JoinType joinType, EndType endType)
+    { for (size_t i = 0; i < paths.size(); ++ i) AddPath(paths[i], joinType, endType); }
   void Execute(Paths& solution, double delta);
   void Execute(PolyTree& solution, double delta);
   void Clear();
+  // Bytes of the buffers kept for the next operation, see ClipperBase::BuffersSize().
+  size_t BuffersSize() const;
   double MiterLimit;
   double ArcTolerance;
   double ShortestEdgeLength;
@@ -460,15 +497,147 @@ private:
   IntPoint m_lowest;
   PolyNode m_polyNodes;
 
+  // Add a path stripped of the duplicate points, k is the index of its lowest point.
+  void AddPolyNode(PolyNode *newNode, int k, EndType endType);
   void FixOrientations();
   void DoOffset(double delta);
   void OffsetPoint(int j, int& k, JoinType jointype);
   void DoSquare(int j, int k);
   void DoMiter(int j, int k, double r);
   void DoRound(int j, int k);
+
+  // Cleans up the offsetted paths, kept between the calls to Execute() to reuse its memory.
+  Clipper m_clipper;
 };
 //------------------------------------------------------------------------------
 
+template<typename PathT>
+int ClipperBase::HighIndex(const PathT &pg, bool Closed)
+{
+  // Remove duplicate end point from a closed input path.
+  // Remove duplicate points from the end of the input path.
+  int highI = (int)pg.size() -1;
+  if (Closed) 
+    while (highI > 0 && (IntPoint(pg[highI]) == IntPoint(pg[0]))) 
+      --highI;
+  while (highI > 0 && (IntPoint(pg[highI]) == IntPoint(pg[highI -1]))) 
+    --highI;
+  if ((Closed && highI < 2) || (!Closed && highI < 1))
+    highI = -1;
+  return highI;
+}
+//------------------------------------------------------------------------------
+
+template<typename PathT>
+bool ClipperBase::AddPath(const PathT &pg, PolyType PolyTyp, bool Closed)
+{
+  int highI = HighIndex(pg, Closed);
+  if (highI < 0)
+    return false;
+
+  // Allocate a new edge array.
+  std::vector<TEdge> &edges = AllocateEdges(highI + 1);
+  // Fill in the edge array.
+  for (int i = 0; i <= highI; ++ i)
+    edges[i].Curr = pg[i];
+  bool result = AddPathInternal(highI, PolyTyp, Closed, edges.data());
+  if (result)
+    // Success, remember the edge array.
+    CommitEdges();
+  return result;
+}
+//------------------------------------------------------------------------------
+
+template<typename PathsT>
+bool ClipperBase::AddPaths(const PathsT &ppg, PolyType PolyTyp, bool Closed)
+{
+  std::vector<int> num_edges(ppg.size(), 0);
+  int num_edges_total = 0;
+  for (size_t i = 0; i < ppg.size(); ++ i) {
+    num_edges[i] = HighIndex(ppg[i], Closed) + 1;
+    num_edges_total += num_edges[i];
+  }
+  if (num_edges_total == 0)
+    return false;
+
+  // Allocate a new edge array.
+  std::vector<TEdge> &edges = AllocateEdges(num_edges_total);
+  // Fill in the edge array.
+  bool result = false;
+  TEdge *p_edge = edges.data();
+  for (size_t i = 0; i < ppg.size(); ++ i)
+    if (num_edges[i]) {
+      const auto &pg = ppg[i];
+      for (int j = 0; j < num_edges[i]; ++ j)
+        p_edge[j].Curr = pg[j];
+      bool res = AddPathInternal(num_edges[i] - 1, PolyTyp, Closed, p_edge);
+      if (res) {
+        p_edge += num_edges[i];
+        result = true;
+      }
+    }
+  if (result)
+    // At least some edges were generated. Remember the edge array.
+    CommitEdges();
+  return result;
+}
+//------------------------------------------------------------------------------
+
+template<typename PathT>
+void ClipperOffset::AddPath(const PathT& path, JoinType joinType, EndType endType)
+{
+  int highI = (int)path.size() - 1;
+  if (highI < 0) return;
+  PolyNode* newNode = new PolyNode();
+  newNode->m_jointype = joinType;
+  newNode->m_endtype = endType;
+
+  //strip duplicate points from path and also get index to the lowest point ...
+  bool   has_shortest_edge_length = ShortestEdgeLength > 0.;
+  double shortest_edge_length2 = has_shortest_edge_length ? ShortestEdgeLength * ShortestEdgeLength : 0.;
+  const IntPoint pt0 = path[0];
+  if (endType == etClosedLine || endType == etClosedPolygon)
+    for (; highI > 0; -- highI) {
+      const IntPoint pt = path[highI];
+      bool same = false;
+      if (has_shortest_edge_length) {
+        double dx = double(pt.X - pt0.X);
+        double dy = double(pt.Y - pt0.Y);
+        same = dx*dx + dy*dy < shortest_edge_length2;
+      } else
+        same = pt0 == pt;
+      if (! same)
+        break;
+    }
+  newNode->Contour.reserve(highI + 1);
+  newNode->Contour.push_back(pt0);
+  int j = 0, k = 0;
+  for (int i = 1; i <= highI; i++) {
+    const IntPoint pt = path[i];
+    bool same = false;
+    if (has_shortest_edge_length) {
+      double dx = double(pt.X - newNode->Contour[j].X);
+      double dy = double(pt.Y - newNode->Contour[j].Y);
+      same = dx*dx + dy*dy < shortest_edge_length2;
+    } else
+      same = newNode->Contour[j] == pt;
+    if (same)
+      continue;
+    j++;
+    newNode->Contour.push_back(pt);
+    if (pt.Y > newNode->Contour[k].Y ||
+      (pt.Y == newNode->Contour[k].Y &&
+      pt.X < newNode->Contour[k].X)) k = j;
+  }
+  if (endType == etClosedPolygon && j < 2)
+  {
+    delete newNode;
+    return;
+  }
+  AddPolyNode(newNode, k, endType);
+}
+//------------------------------------------------------------------------------
+
 class clipperException : public std::exception
 {
   public:
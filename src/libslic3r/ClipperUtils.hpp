@@ -7,6 +7,9 @@
 #include "Polygon.hpp"
 #include "Surface.hpp"
 
+#include <memory>
+#include <vector>
+
 // import these wherever we're included
 using ClipperLib::jtMiter;
 using ClipperLib::jtRound;
@@ -26,6 +29,105 @@ using ClipperLib::jtSquare;
 
 namespace Slic3r {
 
+namespace ClipperUtils {
+    // Points of a Slic3r polygon or polyline viewed as a Clipper path. ClipperLib::Clipper::AddPath() and ClipperLib::ClipperOffset::AddPath()
+    // read the points through the view, so the input does not have to be converted to a ClipperLib::Path first.
+    // If Scaled, the points are scaled by CLIPPER_OFFSET_SCALE as required by the offset, if Reversed, they are read from the back.
+    template<bool Scaled, bool Reversed = false>
+    class PointsPath
+    {
+    public:
+        explicit PointsPath(const Points &points) : m_points(points) {}
+        size_t size() const { return m_points.size(); }
+        ClipperLib::IntPoint operator[](size_t idx) const {
+            const Point &pt = m_points[Reversed ? m_points.size() - 1 - idx : idx];
+            return Scaled ?
+                ClipperLib::IntPoint(ClipperLib::cInt(pt(0)) << CLIPPER_OFFSET_POWER_OF_2, ClipperLib::cInt(pt(1)) << CLIPPER_OFFSET_POWER_OF_2) :
+                ClipperLib::IntPoint(pt(0), pt(1));
+        }
+    private:
+        const Points &m_points;
+    };
+
+    // Polygons or Polylines viewed as Clipper paths.
+    template<bool Scaled, typename MultiPointsT>
+    class MultiPointsPaths
+    {
+    public:
+        explicit MultiPointsPaths(const MultiPointsT &src) : m_src(src) {}
+        size_t size() const { return m_src.size(); }
+        PointsPath<Scaled> operator[](size_t idx) const { return PointsPath<Scaled>(m_src[idx].points); }
+    private:
+        const MultiPointsT &m_src;
+    };
+
+    template<bool Scaled, typename MultiPointsT>
+    MultiPointsPaths<Scaled, MultiPointsT> multi_points_paths(const MultiPointsT &src) { return MultiPointsPaths<Scaled, MultiPointsT>(src); }
+
+    // Return a Clipper engine to the state of a newly constructed one, keeping the memory it allocated.
+    inline void reset_engine(ClipperLib::Clipper &clipper)
+    {
+        clipper.Clear();
+        clipper.PreserveCollinear(false);
+        clipper.StrictlySimple(false);
+        clipper.ReverseSolution(false);
+    }
+    inline void reset_engine(ClipperLib::ClipperOffset &co)
+    {
+        co.Clear();
+        co.MiterLimit         = 2.;
+        co.ArcTolerance       = 0.25;
+        co.ShortestEdgeLength = 0.;
+    }
+
+    // The pools of the engines live as long as the worker threads, therefore they are bounded: Only a few engines
+    // are kept per thread (the nesting is shallow), and an engine which grew its buffers on a huge input is released
+    // instead of holding on to that memory for the rest of the application run.
+    enum {
+        PooledEnginesMax        = 4,
+        PooledEngineBuffersMax  = 8 * 1024 * 1024,
+    };
+
+    // A ClipperLib::Clipper or a ClipperLib::ClipperOffset borrowed from a pool of the calling thread for the lifetime
+    // of the PooledEngine. The engines keep their edges, output points and scan beam when cleared, so the Clipper
+    // operations repeated over the layers and regions by a worker thread do not allocate and release these buffers
+    // over and over. A nested operation borrows another engine of the pool. The engine is returned cleared and with
+    // its default settings.
+    template<typename EngineT>
+    class PooledEngine
+    {
+    public:
+        PooledEngine() {
+            std::vector<std::unique_ptr<EngineT>> &engines = pool();
+            if (engines.empty())
+                m_engine.reset(new EngineT());
+            else {
+                m_engine = std::move(engines.back());
+                engines.pop_back();
+            }
+        }
+        ~PooledEngine() {
+            reset_engine(*m_engine);
+            std::vector<std::unique_ptr<EngineT>> &engines = pool();
+            if (engines.size() < PooledEnginesMax && m_engine->BuffersSize() <= PooledEngineBuffersMax)
+                engines.emplace_back(std::move(m_engine));
+        }
+        PooledEngine(const PooledEngine &) = delete;
+        PooledEngine& operator=(const PooledEngine &) = delete;
+
+        EngineT& operator*()  { return *m_engine; }
+        EngineT* operator->() { return m_engine.get(); }
+
+    private:
+        static std::vector<std::unique_ptr<EngineT>>& pool() {
+            static thread_local std::vector<std::unique_ptr<EngineT>> engines;
+            return engines;
+        }
+
+        std::unique_ptr<EngineT> m_engine;
+    };
+}
+
 //-----------------------------------------------------------
 // legacy code from Clipper documentation
 void AddOuterPolyNodeToExPolygons(ClipperLib::PolyNode& polynode, Slic3r::ExPolygons& expolygons);
@@ -44,16 +146,20 @@ Slic3r::ExPolygons ClipperPaths_to_Slic3rExPolygons(const ClipperLib::Paths &inp
 // offset Polygons
 ClipperLib::Paths _offset(ClipperLib::Path &&input, ClipperLib::EndType endType, const float delta, ClipperLib::JoinType joinType, double miterLimit);
 ClipperLib::Paths _offset(ClipperLib::Paths &&input, ClipperLib::EndType endType, const float delta, ClipperLib::JoinType joinType, double miterLimit);
+// The Slic3r paths are read by the ClipperOffset directly, without being converted to ClipperLib::Paths first.
+ClipperLib::Paths _offset(const Slic3r::MultiPoint &input, ClipperLib::EndType endType, const float delta, ClipperLib::JoinType joinType, double miterLimit);
+ClipperLib::Paths _offset(const Slic3r::Polygons &input, ClipperLib::EndType endType, const float delta, ClipperLib::JoinType joinType, double miterLimit);
+ClipperLib::Paths _offset(const Slic3r::Polylines &input, ClipperLib::EndType endType, const float delta, ClipperLib::JoinType joinType, double miterLimit);
 inline Slic3r::Polygons offset(const Slic3r::Polygon &polygon, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter,  double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rPolygons(_offset(Slic3rMultiPoint_to_ClipperPath(polygon), ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
+    { return ClipperPaths_to_Slic3rPolygons(_offset(polygon, ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
 inline Slic3r::Polygons offset(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rPolygons(_offset(Slic3rMultiPoints_to_ClipperPaths(polygons), ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
+    { return ClipperPaths_to_Slic3rPolygons(_offset(polygons, ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
 
 // offset Polylines
 inline Slic3r::Polygons offset(const Slic3r::Polyline &polyline, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtSquare, double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rPolygons(_offset(Slic3rMultiPoint_to_ClipperPath(polyline), ClipperLib::etOpenButt, delta, joinType, miterLimit)); }
+    { return ClipperPaths_to_Slic3rPolygons(_offset(polyline, ClipperLib::etOpenButt, delta, joinType, miterLimit)); }
 inline Slic3r::Polygons offset(const Slic3r::Polylines &polylines, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtSquare, double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rPolygons(_offset(Slic3rMultiPoints_to_ClipperPaths(polylines), ClipperLib::etOpenButt, delta, joinType, miterLimit)); }
+    { return ClipperPaths_to_Slic3rPolygons(_offset(polylines, ClipperLib::etOpenButt, delta, joinType, miterLimit)); }
 
 // offset expolygons and surfaces
 ClipperLib::Paths _offset(const Slic3r::ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType, double miterLimit);
@@ -63,9 +169,9 @@ inline Slic3r::Polygons offset(const Slic3r::ExPolygon &expolygon, const float d
 inline Slic3r::Polygons offset(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
     { return ClipperPaths_to_Slic3rPolygons(_offset(expolygons, delta, joinType, miterLimit)); }
 inline Slic3r::ExPolygons offset_ex(const Slic3r::Polygon &polygon, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rExPolygons(_offset(Slic3rMultiPoint_to_ClipperPath(polygon), ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }    
+    { return ClipperPaths_to_Slic3rExPolygons(_offset(polygon, ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }    
 inline Slic3r::ExPolygons offset_ex(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
-    { return ClipperPaths_to_Slic3rExPolygons(_offset(Slic3rMultiPoints_to_ClipperPaths(polygons), ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
+    { return ClipperPaths_to_Slic3rExPolygons(_offset(polygons, ClipperLib::etClosedPolygon, delta, joinType, miterLimit)); }
 inline Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
     { return ClipperPaths_to_Slic3rExPolygons(_offset(expolygon, delta, joinType, miterLimit)); }
 inline Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType = ClipperLib::jtMiter, double miterLimit = 3)
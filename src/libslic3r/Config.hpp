@@ -4,12 +4,15 @@
 #include <assert.h>
 #include <map>
 #include <climits>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "libslic3r.h"
 #include "Point.hpp"
@@ -101,6 +104,45 @@ enum PrinterTechnology
     ptAny
 };
 
+// Hashing of the configuration values for ConfigOption::hash().
+// The hashes do not depend on the platform or on the implementation of std::hash, so that they may be stored and compared later.
+// Equal values hash equal, therefore the hashes of the floating point values do not distinguish 0. from -0.
+inline uint64_t config_hash_combine(uint64_t seed, uint64_t value)
+{
+    uint64_t h = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    // Finalizer of the MurmurHash3, so that all bits of the value affect all bits of the hash.
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+inline uint64_t config_value_hash(bool value)          { return value ? 1 : 0; }
+inline uint64_t config_value_hash(unsigned char value) { return value; }
+inline uint64_t config_value_hash(int value)           { return uint64_t(int64_t(value)); }
+inline uint64_t config_value_hash(double value)
+{
+    if (value == 0.)
+        // Hash -0. as 0.
+        value = 0.;
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+inline uint64_t config_value_hash(const std::string &value)
+{
+    // 64 bit FNV-1a
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (unsigned char c : value)
+        h = (h ^ c) * 0x100000001b3ull;
+    return h;
+}
+inline uint64_t config_value_hash(const Vec2d &value) { return config_hash_combine(config_value_hash(value(0)), config_value_hash(value(1))); }
+inline uint64_t config_value_hash(const Vec3d &value) { return config_hash_combine(config_value_hash(Vec2d(value(0), value(1))), config_value_hash(value(2))); }
+template<typename T>
+inline typename std::enable_if<std::is_enum<T>::value, uint64_t>::type config_value_hash(T value) { return uint64_t(int64_t(value)); }
+
 // A generic value of a configuration option.
 class ConfigOption {
 public:
@@ -118,6 +160,8 @@ public:
     virtual void                setInt(int /* val */) { throw std::runtime_error("Calling ConfigOption::setInt on a non-int ConfigOption"); }
     virtual bool                operator==(const ConfigOption &rhs) const = 0;
     bool                        operator!=(const ConfigOption &rhs) const { return ! (*this == rhs); }
+    // Hash of the value. Options comparing equal have the same hash.
+    virtual uint64_t            hash() const = 0;
     bool                        is_scalar()     const { return (int(this->type()) & int(coVectorType)) == 0; }
     bool                        is_vector()     const { return ! this->is_scalar(); }
 };
@@ -149,6 +193,8 @@ public:
         return this->value == static_cast<const ConfigOptionSingle<T>*>(&rhs)->value;
     }
 
+    uint64_t hash() const override { return config_value_hash(this->value); }
+
     bool operator==(const T &rhs) const { return this->value == rhs; }
     bool operator!=(const T &rhs) const { return this->value != rhs; }
 };
@@ -287,6 +333,14 @@ public:
         return this->values == static_cast<const ConfigOptionVector<T>*>(&rhs)->values;
     }
 
+    uint64_t hash() const override
+    {
+        uint64_t h = this->values.size();
+        for (const T &value : this->values)
+            h = config_hash_combine(h, config_value_hash(value));
+        return h;
+    }
+
     bool operator==(const std::vector<T> &rhs) const { return this->values == rhs; }
     bool operator!=(const std::vector<T> &rhs) const { return this->values != rhs; }
 };
@@ -633,6 +687,7 @@ public:
     }
     bool                        operator==(const ConfigOptionFloatOrPercent &rhs) const 
         { return this->value == rhs.value && this->percent == rhs.percent; }
+    uint64_t                    hash() const override { return config_hash_combine(config_value_hash(this->value), config_value_hash(this->percent)); }
     double                      get_abs_value(double ratio_over) const 
         { return this->percent ? (ratio_over * this->value / 100) : this->value; }
 
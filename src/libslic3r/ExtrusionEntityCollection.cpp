@@ -1,7 +1,7 @@
 #include "ExtrusionEntityCollection.hpp"
+#include "ShortestPath.hpp"
 #include <algorithm>
 #include <cmath>
-#include <map>
 
 namespace Slic3r {
 
@@ -111,10 +111,9 @@ void ExtrusionEntityCollection::chained_path_from(Point start_near, ExtrusionEnt
     retval->entities.reserve(this->entities.size());
     retval->orig_indices.reserve(this->entities.size());
     
-    // if we're asked to return the original indices, build a map
-    std::map<ExtrusionEntity*,size_t> indices_map;
-    
+    // Clones of the entities to be ordered and their indices in this collection.
     ExtrusionEntitiesPtr my_paths;
+    std::vector<size_t>  my_indices;
     for (ExtrusionEntitiesPtr::const_iterator it = this->entities.begin(); it != this->entities.end(); ++it) {
         if (role != erMixed) {
             // The caller wants only paths with a specific extrusion role.
@@ -126,12 +125,12 @@ void ExtrusionEntityCollection::chained_path_from(Point start_near, ExtrusionEnt
             }
         }
 
-        ExtrusionEntity* entity = (*it)->clone();
-        my_paths.push_back(entity);
-        if (orig_indices != NULL) indices_map[entity] = it - this->entities.begin();
+        my_paths.push_back((*it)->clone());
+        my_indices.push_back(it - this->entities.begin());
     }
     
     Points endpoints;
+    endpoints.reserve(2 * my_paths.size());
     for (ExtrusionEntitiesPtr::iterator it = my_paths.begin(); it != my_paths.end(); ++it) {
         endpoints.push_back((*it)->first_point());
         if (no_reverse || !(*it)->can_reverse()) {
@@ -141,20 +140,20 @@ void ExtrusionEntityCollection::chained_path_from(Point start_near, ExtrusionEnt
         }
     }
     
-    while (!my_paths.empty()) {
+    ClosestEndPointIndex index(endpoints, 2, ClosestEndPointIndex::tbLastUnlessCoincident);
+    while (index.num_items_left() > 0) {
         // find nearest point
-        int start_index = start_near.nearest_point_index(endpoints);
-        int path_index = start_index/2;
-        ExtrusionEntity* entity = my_paths.at(path_index);
+        size_t start_index = index.closest(start_near);
+        size_t path_index = start_index/2;
+        ExtrusionEntity* entity = my_paths[path_index];
         // never reverse loops, since it's pointless for chained path and callers might depend on orientation
         if (start_index % 2 && !no_reverse && entity->can_reverse()) {
             entity->reverse();
         }
-        retval->entities.push_back(my_paths.at(path_index));
-        if (orig_indices != NULL) orig_indices->push_back(indices_map[entity]);
-        my_paths.erase(my_paths.begin() + path_index);
-        endpoints.erase(endpoints.begin() + 2*path_index, endpoints.begin() + 2*path_index + 2);
-        start_near = retval->entities.back()->last_point();
+        retval->entities.push_back(entity);
+        if (orig_indices != NULL) orig_indices->push_back(my_indices[path_index]);
+        index.remove_item(path_index);
+        start_near = entity->last_point();
     }
 }
 
@@ -25,6 +25,8 @@
 
 #include <Shiny/Shiny.h>
 
+#include <tbb/pipeline.h>
+
 #if 0
 // Enable debugging and asserts, even in the release build.
 #define DEBUG
@@ -36,6 +38,9 @@
 
 namespace Slic3r {
 
+// Interval of the M73 remaining times lines, in seconds.
+static const float REMAINING_TIMES_INTERVAL_SEC = 60.0f;
+
 // Only add a newline in case the current G-code does not end with a newline.
 static inline void check_add_eol(std::string &gcode)
 {
@@ -439,6 +444,8 @@ void GCode::do_export(Print *print, const char *path, GCodePreviewData *preview_
     FILE *file = boost::nowide::fopen(path_tmp.c_str(), "wb");
     if (file == nullptr)
         throw std::runtime_error(std::string("G-code export to ") + path + " failed.\nCannot open the file for writing.\n");
+    // The G-code is written layer by layer, let the C runtime collect it into large blocks to reduce the number of system calls.
+    setvbuf(file, nullptr, _IOFBF, 1024 * 1024);
 
     m_enable_analyzer = preview_data != nullptr;
 
@@ -474,14 +481,14 @@ void GCode::do_export(Print *print, const char *path, GCodePreviewData *preview_
     }
 
     if (print->config().remaining_times.value) {
-        BOOST_LOG_TRIVIAL(debug) << "Processing remaining times for normal mode";
-        m_normal_time_estimator.post_process_remaining_times(path_tmp, 60.0f);
+        BOOST_LOG_TRIVIAL(debug) << "Processing remaining times for normal" << (m_silent_time_estimator_enabled ? " and silent mode" : " mode");
+        std::vector<const GCodeTimeEstimator*> estimators { &m_normal_time_estimator };
+        if (m_silent_time_estimator_enabled)
+            estimators.emplace_back(&m_silent_time_estimator);
+        GCodeTimeEstimator::post_process_remaining_times(path_tmp, REMAINING_TIMES_INTERVAL_SEC, estimators);
         m_normal_time_estimator.reset();
-        if (m_silent_time_estimator_enabled) {
-            BOOST_LOG_TRIVIAL(debug) << "Processing remaining times for silent mode";
-            m_silent_time_estimator.post_process_remaining_times(path_tmp, 60.0f);
+        if (m_silent_time_estimator_enabled)
             m_silent_time_estimator.reset();
-        }
     }
 
     // starts analyzer calculations
@@ -571,6 +578,9 @@ void GCode::_do_export(Print &print, FILE *file)
         m_normal_time_estimator.set_filament_load_times(print.config().filament_load_time.values);
         m_normal_time_estimator.set_filament_unload_times(print.config().filament_unload_time.values);
     }
+    // The time estimators keep just the elapsed times needed to export the remaining times, not the whole move history.
+    m_normal_time_estimator.set_remaining_times_interval(REMAINING_TIMES_INTERVAL_SEC);
+    m_silent_time_estimator.set_remaining_times_interval(REMAINING_TIMES_INTERVAL_SEC);
 
     // resets analyzer
     m_analyzer.reset();
@@ -673,6 +683,7 @@ void GCode::_do_export(Print &print, FILE *file)
     m_cooling_buffer = make_unique<CoolingBuffer>(*this);
     if (print.config().spiral_vase.value)
         m_spiral_vase = make_unique<SpiralVase>(print.config());
+    m_spiral_vase_enable = false;
 #ifdef HAS_PRESSURE_EQUALIZER
     if (print.config().max_volumetric_extrusion_rate_slope_positive.value > 0 ||
         print.config().max_volumetric_extrusion_rate_slope_negative.value > 0)
@@ -928,12 +939,19 @@ void GCode::_do_export(Print &print, FILE *file)
                 m_cooling_buffer->set_current_extruder(initial_extruder_id);
                 // Pair the object layers with the support layers by z, extrude them.
                 std::vector<LayerToPrint> layers_to_print = collect_layers_to_print(object);
-                for (const LayerToPrint &ltp : layers_to_print) {
-                    std::vector<LayerToPrint> lrs;
-                    lrs.emplace_back(std::move(ltp));
-                    this->process_layer(file, print, lrs, tool_ordering.tools_for_layer(ltp.print_z()), &copy - object.copies().data());
-                    print.throw_if_canceled();
-                }
+                size_t copy_idx = &copy - object.copies().data();
+                this->process_layers(file, layers_to_print.size(), 
+                    [&print, &layers_to_print](size_t idx_layer) {
+                        return prepare_layer(print, std::vector<LayerToPrint>(1, layers_to_print[idx_layer]));
+                    },
+                    [this, &print, &tool_ordering, &layers_to_print, copy_idx](size_t idx_layer, const PreparedLayer &prepared_layer) {
+                        const LayerToPrint        &ltp = layers_to_print[idx_layer];
+                        std::vector<LayerToPrint>  lrs;
+                        lrs.emplace_back(ltp);
+                        LayerResult result = this->process_layer(print, lrs, tool_ordering.tools_for_layer(ltp.print_z()), prepared_layer, copy_idx);
+                        print.throw_if_canceled();
+                        return result;
+                    });
 #ifdef HAS_PRESSURE_EQUALIZER
                 if (m_pressure_equalizer)
                     _write(file, m_pressure_equalizer->process("", true));
@@ -985,13 +1003,19 @@ void GCode::_do_export(Print &print, FILE *file)
             print.throw_if_canceled();
         }
         // Extrude the layers.
-        for (auto &layer : layers_to_print) {
-            const LayerTools &layer_tools = tool_ordering.tools_for_layer(layer.first);
-            if (m_wipe_tower && layer_tools.has_wipe_tower)
-                m_wipe_tower->next_layer();
-            this->process_layer(file, print, layer.second, layer_tools, size_t(-1));
-            print.throw_if_canceled();
-        }
+        this->process_layers(file, layers_to_print.size(), 
+            [&print, &layers_to_print](size_t idx_layer) {
+                return prepare_layer(print, layers_to_print[idx_layer].second);
+            },
+            [this, &print, &tool_ordering, &layers_to_print](size_t idx_layer, const PreparedLayer &prepared_layer) {
+                const std::pair<coordf_t, std::vector<LayerToPrint>> &layer = layers_to_print[idx_layer];
+                const LayerTools &layer_tools = tool_ordering.tools_for_layer(layer.first);
+                if (m_wipe_tower && layer_tools.has_wipe_tower)
+                    m_wipe_tower->next_layer();
+                LayerResult result = this->process_layer(print, layer.second, layer_tools, prepared_layer, size_t(-1));
+                print.throw_if_canceled();
+                return result;
+            });
 #ifdef HAS_PRESSURE_EQUALIZER
         if (m_pressure_equalizer)
             _write(file, m_pressure_equalizer->process("", true));
@@ -1037,9 +1061,9 @@ void GCode::_do_export(Print &print, FILE *file)
     print.throw_if_canceled();
 
     // calculates estimated printing time
-    m_normal_time_estimator.calculate_time(false);
+    m_normal_time_estimator.calculate_time();
     if (m_silent_time_estimator_enabled)
-        m_silent_time_estimator.calculate_time(false);
+        m_silent_time_estimator.calculate_time();
 
     // Get filament stats.
     print.m_print_statistics.clear();
@@ -1259,18 +1283,75 @@ inline std::vector<GCode::ObjectByExtruder::Island>& object_islands_by_extruder(
     return islands;
 }
 
+// Calculate the data of the layers, which are expensive to calculate, but which only depend on the Print.
+// They are calculated ahead of process_layer() by the layer pipeline.
+GCode::PreparedLayer GCode::prepare_layer(const Print &print, const std::vector<LayerToPrint> &layers)
+{
+    PreparedLayer prepared;
+    // The configuration space for avoid_crossing_perimeters over the slices of each object. The motion planners are shared
+    // by all the extruders printing the layer, so that the graphs created on demand are reused.
+    if (print.config().avoid_crossing_perimeters) {
+        prepared.layer_motion_planners.assign(layers.size(), std::shared_ptr<MotionPlanner>());
+        for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id)
+            if (const Layer *layer = layers[layer_id].layer()) {
+                auto mp = std::make_shared<MotionPlanner>(union_ex(layer->slices, true));
+                mp->initialize();
+                prepared.layer_motion_planners[layer_id] = std::move(mp);
+            }
+    }
+    // The signed distance fields over the slices of the layers below the object layers, which are used by extrude_loop()
+    // to penalize the seam candidates overhanging the layer below. The distance fields are only needed, if the seam is placed
+    // by the penalty function.
+    std::vector<std::shared_ptr<const EdgeGrid::Grid>> &lower_layer_edge_grids = prepared.lower_layer_edge_grids;
+    lower_layer_edge_grids.assign(layers.size(), std::shared_ptr<const EdgeGrid::Grid>());
+    if (print.config().spiral_vase)
+        // The spiral vase does not place seams.
+        return prepared;
+    for (size_t layer_id = 0; layer_id < layers.size(); ++ layer_id) {
+        const Layer *layer = layers[layer_id].object_layer;
+        if (layer == nullptr || layer->lower_layer == nullptr || layer->object()->config().seam_position == spRandom)
+            continue;
+        bool has_perimeters = false;
+        for (const LayerRegion *layerm : layer->regions())
+            if (! layerm->perimeters.entities.empty()) {
+                has_perimeters = true;
+                break;
+            }
+        if (! has_perimeters)
+            continue;
+        // Create the distance field for a layer below.
+        const coord_t distance_field_resolution = coord_t(scale_(1.) + 0.5);
+        std::shared_ptr<EdgeGrid::Grid> grid = std::make_shared<EdgeGrid::Grid>();
+        grid->create(layer->lower_layer->slices, distance_field_resolution);
+        grid->calculate_sdf();
+        #if 0
+        {
+            static int iRun = 0;
+            BoundingBox bbox = grid->bbox();
+            bbox.min(0) -= scale_(5.f);
+            bbox.min(1) -= scale_(5.f);
+            bbox.max(0) += scale_(5.f);
+            bbox.max(1) += scale_(5.f);
+            EdgeGrid::save_png(*grid, bbox, scale_(0.1f), debug_out_path("GCode_extrude_loop_edge_grid-%d.png", iRun++));
+        }
+        #endif
+        lower_layer_edge_grids[layer_id] = std::move(grid);
+    }
+    return prepared;
+}
+
 // In sequential mode, process_layer is called once per each object and its copy, 
 // therefore layers will contain a single entry and single_object_idx will point to the copy of the object.
 // In non-sequential mode, process_layer is called per each print_z height with all object and support layers accumulated.
 // For multi-material prints, this routine minimizes extruder switches by gathering extruder specific extrusion paths
 // and performing the extruder specific extrusions together.
-void GCode::process_layer(
-    // Write into the output file.
-    FILE                            *file,
+GCode::LayerResult GCode::process_layer(
     const Print                     &print,
     // Set of object & print layers of the same PrintObject and with the same print_z.
     const std::vector<LayerToPrint> &layers,
     const LayerTools                &layer_tools,
+    // Produced by prepare_layer() for the layers above.
+    const PreparedLayer             &prepared_layer,
     // If set to size_t(-1), then print all copies of all objects.
     // Otherwise print a single copy of a single object.
     const size_t                     single_object_idx)
@@ -1280,9 +1361,10 @@ void GCode::process_layer(
     // Either printing all copies of all objects, or just a single copy of a single object.
     assert(single_object_idx == size_t(-1) || layers.size() == 1);
 
+    LayerResult result;
     if (layer_tools.extruders.empty())
         // Nothing to extrude.
-        return;
+        return result;
 
     // Extract 1st object_layer and support_layer of this set of layers with an equal print_z.
     const Layer         *object_layer  = nullptr;
@@ -1314,10 +1396,11 @@ void GCode::process_layer(
                     break;
                 }
         }
-        m_spiral_vase->enable = enable;
+        m_spiral_vase_enable = enable;
     }
+    result.spiral_vase_enable = m_spiral_vase_enable;
     // If we're going to apply spiralvase to this layer, disable loop clipping
-    m_enable_loop_clipping = ! m_spiral_vase || ! m_spiral_vase->enable;
+    m_enable_loop_clipping = ! m_spiral_vase_enable;
     
     std::string gcode;
 
@@ -1554,7 +1637,6 @@ void GCode::process_layer(
     } // for objects
 
     // Extrude the skirt, brim, support, perimeters, infill ordered by the extruders.
-    std::vector<std::unique_ptr<EdgeGrid::Grid>> lower_layer_edge_grids(layers.size());
     for (unsigned int extruder_id : layer_tools.extruders)
     {
         gcode += (layer_tools.has_wipe_tower && m_wipe_tower) ?
@@ -1624,7 +1706,7 @@ void GCode::process_layer(
                 m_config.apply(print_object->config(), true);
                 m_layer = layers[layer_id].layer();
                 if (m_config.avoid_crossing_perimeters)
-                    m_avoid_crossing_perimeters.init_layer_mp(union_ex(m_layer->slices, true));
+                    m_avoid_crossing_perimeters.init_layer_mp(prepared_layer.layer_motion_planners[layer_id]);
                 Points copies;
                 if (single_object_idx == size_t(-1))
                     copies = print_object->copies();
@@ -1654,9 +1736,9 @@ void GCode::process_layer(
 
                         if (print.config().infill_first) {
                             gcode += this->extrude_infill(print, by_region_specific);
-                            gcode += this->extrude_perimeters(print, by_region_specific, lower_layer_edge_grids[layer_id]);
+                            gcode += this->extrude_perimeters(print, by_region_specific, prepared_layer.lower_layer_edge_grids[layer_id].get());
                         } else {
-                            gcode += this->extrude_perimeters(print, by_region_specific, lower_layer_edge_grids[layer_id]);
+                            gcode += this->extrude_perimeters(print, by_region_specific, prepared_layer.lower_layer_edge_grids[layer_id].get());
                             gcode += this->extrude_infill(print,by_region_specific);
                         }
                     }
@@ -1668,32 +1750,94 @@ void GCode::process_layer(
         }
     }
 
-    // Apply spiral vase post-processing if this layer contains suitable geometry
-    // (we must feed all the G-code into the post-processor, including the first 
-    // bottom non-spiral layers otherwise it will mess with positions)
-    // we apply spiral vase at this stage because it requires a full layer.
-    // Just a reminder: A spiral vase mode is allowed for a single object per layer, single material print only.
-    if (m_spiral_vase)
-        gcode = m_spiral_vase->process_layer(gcode);
-
-    // Apply cooling logic; this may alter speeds.
-    if (m_cooling_buffer)
-        gcode = m_cooling_buffer->process_layer(gcode, layer.id());
+    result.gcode    = std::move(gcode);
+    result.layer_id = layer.id();
+    return result;
+}
 
+void GCode::process_layers(FILE *file, size_t num_layers,
+    std::function<PreparedLayer(size_t)>                      prepare_layer,
+    std::function<LayerResult(size_t, const PreparedLayer&)> generate_layer)
+{
+    // The G-code generator keeps its state (position, retraction, the active extruder, the wipe tower)
+    // from one layer to the next, therefore the layers are generated strictly in order.
+    // The G-code filters and the output into a file are stateful as well, but each of them only depends
+    // on the previous layers passed through the same filter. Run them as stages of a pipeline,
+    // so that they work on the preceding layers while the following layer is being generated.
+    // The distance fields of the layers below used for the seam placement and the motion planners used to avoid crossing
+    // perimeters only depend on the Print, therefore they are calculated for the following layers in parallel
+    // before their G-code is generated.
+    // The number of layers in flight is limited to bound the memory consumed by the layer G-code and the prepared data.
+    typedef std::pair<size_t, PreparedLayer> IndexedPreparedLayer;
+    size_t idx_layer = 0;
+    tbb::parallel_pipeline(8,
+        tbb::make_filter<void, size_t>(tbb::filter::serial_in_order,
+            [&idx_layer, num_layers](tbb::flow_control &fc) -> size_t {
+                if (idx_layer == num_layers) {
+                    fc.stop();
+                    return 0;
+                }
+                return idx_layer ++;
+            }) &
+        tbb::make_filter<size_t, IndexedPreparedLayer>(tbb::filter::parallel,
+            [&prepare_layer](size_t idx) -> IndexedPreparedLayer {
+                return IndexedPreparedLayer(idx, prepare_layer(idx));
+            }) &
+        tbb::make_filter<IndexedPreparedLayer, LayerResult>(tbb::filter::serial_in_order,
+            [&generate_layer](const IndexedPreparedLayer &in) -> LayerResult {
+                return generate_layer(in.first, in.second);
+            }) &
+        // Apply spiral vase post-processing if this layer contains suitable geometry
+        // (we must feed all the G-code into the post-processor, including the first 
+        // bottom non-spiral layers otherwise it will mess with positions)
+        // we apply spiral vase at this stage because it requires a full layer.
+        // Just a reminder: A spiral vase mode is allowed for a single object per layer, single material print only.
+        tbb::make_filter<LayerResult, LayerResult>(tbb::filter::serial_in_order,
+            [this](LayerResult in) -> LayerResult {
+                if (m_spiral_vase && in.layer_id != size_t(-1)) {
+                    m_spiral_vase->enable = in.spiral_vase_enable;
+                    in.gcode = m_spiral_vase->process_layer(in.gcode);
+                }
+                return in;
+            }) &
+        // Apply cooling logic; this may alter speeds.
+        tbb::make_filter<LayerResult, LayerResult>(tbb::filter::serial_in_order,
+            [this](LayerResult in) -> LayerResult {
+                if (m_cooling_buffer && in.layer_id != size_t(-1))
+                    in.gcode = m_cooling_buffer->process_layer(in.gcode, in.layer_id);
 #ifdef HAS_PRESSURE_EQUALIZER
-    // Apply pressure equalization if enabled;
-    // printf("G-code before filter:\n%s\n", gcode.c_str());
-    if (m_pressure_equalizer)
-        gcode = m_pressure_equalizer->process(gcode.c_str(), false);
-    // printf("G-code after filter:\n%s\n", out.c_str());
+                // Apply pressure equalization if enabled;
+                // printf("G-code before filter:\n%s\n", gcode.c_str());
+                if (m_pressure_equalizer && in.layer_id != size_t(-1)) {
+                    const char *gcode = m_pressure_equalizer->process(in.gcode.c_str(), false);
+                    in.gcode.assign(gcode, m_pressure_equalizer->get_output_buffer_length());
+                }
+                // printf("G-code after filter:\n%s\n", out.c_str());
 #endif /* HAS_PRESSURE_EQUALIZER */
-    
-    _write(file, gcode);
-    BOOST_LOG_TRIVIAL(trace) << "Exported layer " << layer.id() << " print_z " << print_z << 
-        ", time estimator memory: " <<
-            format_memsize_MB(m_normal_time_estimator.memory_used() + m_silent_time_estimator_enabled ? m_silent_time_estimator.memory_used() : 0) <<
-        ", analyzer memory: " <<
-            format_memsize_MB(m_analyzer.memory_used());
+                return in;
+            }) &
+        // Feed the layer into the G-code analyzer and the time estimators.
+        tbb::make_filter<LayerResult, LayerResult>(tbb::filter::serial_in_order,
+            [this](LayerResult in) -> LayerResult {
+                if (in.layer_id == size_t(-1))
+                    return in;
+                _analyze(in.gcode);
+                BOOST_LOG_TRIVIAL(trace) << "Exported layer " << in.layer_id <<
+                    ", estimated time (normal mode): " << m_normal_time_estimator.get_time_dhms() <<
+                    (m_silent_time_estimator_enabled ? ", estimated time (silent mode): " + m_silent_time_estimator.get_time_dhms() : std::string()) <<
+                    ", time estimator memory: " <<
+                        format_memsize_MB(m_normal_time_estimator.memory_used() + (m_silent_time_estimator_enabled ? m_silent_time_estimator.memory_used() : 0)) <<
+                    ", analyzer memory: " <<
+                        format_memsize_MB(m_analyzer.memory_used());
+                return in;
+            }) &
+        // Write the layer into the file. The layers are written by their own stage, so that the file I/O
+        // overlaps with the analysis of the next layer instead of stalling the pipeline.
+        tbb::make_filter<LayerResult, void>(tbb::filter::serial_in_order,
+            [file](const LayerResult &in) {
+                if (in.layer_id != size_t(-1))
+                    fwrite(in.gcode.data(), 1, in.gcode.size(), file);
+            }));
 }
 
 void GCode::apply_print_config(const PrintConfig &print_config)
@@ -1982,32 +2126,11 @@ std::vector<float> polygon_angles_at_vertices(const Polygon &polygon, const std:
     return angles;
 }
 
-std::string GCode::extrude_loop(ExtrusionLoop loop, std::string description, double speed, std::unique_ptr<EdgeGrid::Grid> *lower_layer_edge_grid)
+std::string GCode::extrude_loop(ExtrusionLoop loop, std::string description, double speed, const EdgeGrid::Grid *lower_layer_edge_grid)
 {
     // get a copy; don't modify the orientation of the original loop object otherwise
     // next copies (if any) would not detect the correct orientation
 
-    if (m_layer->lower_layer != nullptr && lower_layer_edge_grid != nullptr) {
-        if (! *lower_layer_edge_grid) {
-            // Create the distance field for a layer below.
-            const coord_t distance_field_resolution = coord_t(scale_(1.) + 0.5);
-            *lower_layer_edge_grid = make_unique<EdgeGrid::Grid>();
-            (*lower_layer_edge_grid)->create(m_layer->lower_layer->slices, distance_field_resolution);
-            (*lower_layer_edge_grid)->calculate_sdf();
-            #if 0
-            {
-                static int iRun = 0;
-                BoundingBox bbox = (*lower_layer_edge_grid)->bbox();
-                bbox.min(0) -= scale_(5.f);
-                bbox.min(1) -= scale_(5.f);
-                bbox.max(0) += scale_(5.f);
-                bbox.max(1) += scale_(5.f);
-                EdgeGrid::save_png(*(*lower_layer_edge_grid), bbox, scale_(0.1f), debug_out_path("GCode_extrude_loop_edge_grid-%d.png", iRun++));
-            }
-            #endif
-        }
-    }
-  
     // extrude all loops ccw
     bool was_clockwise = loop.make_counter_clockwise();
     
@@ -2093,7 +2216,7 @@ std::string GCode::extrude_loop(ExtrusionLoop loop, std::string description, dou
         }
 
         // Penalty for overhangs.
-        if (lower_layer_edge_grid && (*lower_layer_edge_grid)) {
+        if (lower_layer_edge_grid != nullptr) {
             // Use the edge grid distance field structure over the lower layer to calculate overhangs.
             coord_t nozzle_r = coord_t(floor(scale_(0.5 * nozzle_dmr) + 0.5));
             coord_t search_r = coord_t(floor(scale_(0.8 * nozzle_dmr) + 0.5));
@@ -2103,7 +2226,7 @@ std::string GCode::extrude_loop(ExtrusionLoop loop, std::string description, dou
                 // Signed distance is positive outside the object, negative inside the object.
                 // The point is considered at an overhang, if it is more than nozzle radius
                 // outside of the lower layer contour.
-                bool found = (*lower_layer_edge_grid)->signed_distance(p, search_r, dist);
+                bool found = lower_layer_edge_grid->signed_distance(p, search_r, dist);
                 // If the approximate Signed Distance Field was initialized over lower_layer_edge_grid,
                 // then the signed distnace shall always be known.
                 assert(found);
@@ -2264,7 +2387,7 @@ std::string GCode::extrude_multi_path(ExtrusionMultiPath multipath, std::string
     return gcode;
 }
 
-std::string GCode::extrude_entity(const ExtrusionEntity &entity, std::string description, double speed, std::unique_ptr<EdgeGrid::Grid> *lower_layer_edge_grid)
+std::string GCode::extrude_entity(const ExtrusionEntity &entity, std::string description, double speed, const EdgeGrid::Grid *lower_layer_edge_grid)
 {
     if (const ExtrusionPath* path = dynamic_cast<const ExtrusionPath*>(&entity))
         return this->extrude_path(*path, description, speed);
@@ -2293,13 +2416,13 @@ std::string GCode::extrude_path(ExtrusionPath path, std::string description, dou
 }
 
 // Extrude perimeters: Decide where to put seams (hide or align seams).
-std::string GCode::extrude_perimeters(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region, std::unique_ptr<EdgeGrid::Grid> &lower_layer_edge_grid)
+std::string GCode::extrude_perimeters(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region, const EdgeGrid::Grid *lower_layer_edge_grid)
 {
     std::string gcode;
     for (const ObjectByExtruder::Island::Region &region : by_region) {
         m_config.apply(print.regions()[&region - &by_region.front()]->config());
         for (ExtrusionEntity *ee : region.perimeters.entities)
-            gcode += this->extrude_entity(*ee, "perimeter", -1., &lower_layer_edge_grid);
+            gcode += this->extrude_entity(*ee, "perimeter", -1., lower_layer_edge_grid);
     }
     return gcode;
 }
@@ -2359,13 +2482,20 @@ void GCode::_write(FILE* file, const char *what)
 
         // writes string to file
         fwrite(gcode, 1, ::strlen(gcode), file);
-        // updates time estimator and gcode lines vector
-        m_normal_time_estimator.add_gcode_block(gcode);
-        if (m_silent_time_estimator_enabled)
-            m_silent_time_estimator.add_gcode_block(gcode);
+        // updates time estimators, the G-code is parsed just once for both the normal and the silent mode
+        GCodeTimeEstimator *time_estimators[2] = { &m_normal_time_estimator, &m_silent_time_estimator };
+        GCodeTimeEstimator::add_gcode_block(gcode, time_estimators, m_silent_time_estimator_enabled ? 2 : 1);
     }
 }
 
+void GCode::_analyze(std::string &what)
+{
+    if (m_enable_analyzer)
+        m_analyzer.process_gcode_in_place(what);
+    GCodeTimeEstimator *time_estimators[2] = { &m_normal_time_estimator, &m_silent_time_estimator };
+    GCodeTimeEstimator::add_gcode_block(what.c_str(), time_estimators, m_silent_time_estimator_enabled ? 2 : 1);
+}
+
 void GCode::_writeln(FILE* file, const std::string &what)
 {
     if (! what.empty())
@@ -2557,7 +2687,8 @@ std::string GCode::_extrude(const ExtrusionPath &path, std::string description,
         for (const Line &line : path.polyline.lines()) {
             const double line_length = line.length() * SCALING_FACTOR;
             path_length += line_length;
-            gcode += m_writer.extrude_to_xy(
+            m_writer.extrude_to_xy(
+                gcode,
                 this->point_to_gcode(line.b),
                 e_per_mm * line_length,
                 comment);
@@ -2611,7 +2742,7 @@ std::string GCode::travel_to(const Point &point, ExtrusionRole role, std::string
     Lines lines = travel.lines();
     if (! lines.empty()) {
         for (const Line &line : lines)
-    	    gcode += m_writer.travel_to_xy(this->point_to_gcode(line.b), comment);    
+    	    m_writer.travel_to_xy(gcode, this->point_to_gcode(line.b), comment);
         this->set_last_pos(lines.back().b);
     }
     return gcode;
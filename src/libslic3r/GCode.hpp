@@ -18,6 +18,7 @@
 #include "EdgeGrid.hpp"
 #include "GCode/Analyzer.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -46,13 +47,14 @@ public:
     ~AvoidCrossingPerimeters() {}
 
     void init_external_mp(const ExPolygons &islands) { m_external_mp = Slic3r::make_unique<MotionPlanner>(islands); }
-    void init_layer_mp(const ExPolygons &islands) { m_layer_mp = Slic3r::make_unique<MotionPlanner>(islands); }
+    void init_layer_mp(const ExPolygons &islands) { m_layer_mp = std::make_shared<MotionPlanner>(islands); }
+    void init_layer_mp(const std::shared_ptr<MotionPlanner> &layer_mp) { m_layer_mp = layer_mp; }
 
     Polyline travel_to(const GCode &gcodegen, const Point &point);
 
 private:
     std::unique_ptr<MotionPlanner> m_external_mp;
-    std::unique_ptr<MotionPlanner> m_layer_mp;
+    std::shared_ptr<MotionPlanner> m_layer_mp;
 };
 
 class OozePrevention {
@@ -144,6 +146,7 @@ public:
         m_last_mm3_per_mm(GCodeAnalyzer::Default_mm3_per_mm),
         m_last_width(GCodeAnalyzer::Default_Width),
         m_last_height(GCodeAnalyzer::Default_Height),
+        m_spiral_vase_enable(false),
         m_brim_done(false),
         m_second_layer_things_done(false),
         m_normal_time_estimator(GCodeTimeEstimator::Normal),
@@ -197,24 +200,53 @@ protected:
     };
     static std::vector<GCode::LayerToPrint>                            collect_layers_to_print(const PrintObject &object);
     static std::vector<std::pair<coordf_t, std::vector<LayerToPrint>>> collect_layers_to_print(const Print &print);
-    void            process_layer(
-        // Write into the output file.
-        FILE                            *file,
+    // G-code of a single layer as produced by process_layer(), before being passed through the G-code filters.
+    struct LayerResult
+    {
+        LayerResult() : layer_id(size_t(-1)), spiral_vase_enable(false) {}
+        std::string           gcode;
+        // Set to size_t(-1) if there is nothing to extrude at this layer. Such a layer is not passed through the filters.
+        size_t                layer_id;
+        // Shall the spiral vase post-processing be applied to this layer?
+        bool                  spiral_vase_enable;
+    };
+    // Data of a set of LayerToPrint, which only depend on the Print and its layers. They are calculated by prepare_layer()
+    // for the following layers in parallel, while process_layer() generates the G-code of the current layer.
+    struct PreparedLayer
+    {
+        // Signed distance fields over the slices of the layers below the LayerToPrint entries, used to penalize seams at overhangs.
+        // Indexed the same as the LayerToPrint vector, an entry is null if no seam will be placed against the layer below.
+        std::vector<std::shared_ptr<const EdgeGrid::Grid>>  lower_layer_edge_grids;
+        // Motion planners over the slices of the LayerToPrint entries with their configuration space initialized,
+        // indexed the same as the LayerToPrint vector. Empty if avoid_crossing_perimeters is disabled.
+        std::vector<std::shared_ptr<MotionPlanner>>         layer_motion_planners;
+    };
+    static PreparedLayer prepare_layer(const Print &print, const std::vector<LayerToPrint> &layers);
+    LayerResult     process_layer(
         const Print                     &print,
         // Set of object & print layers of the same PrintObject and with the same print_z.
         const std::vector<LayerToPrint> &layers,
-        const LayerTools  &layer_tools,
+        const LayerTools                &layer_tools,
+        // Produced by prepare_layer() for the layers above.
+        const PreparedLayer             &prepared_layer,
         // If set to size_t(-1), then print all copies of all objects.
         // Otherwise print a single copy of a single object.
         const size_t                     single_object_idx = size_t(-1));
+    // Export num_layers layers produced by generate_layer() in a pipeline: The layers are generated in order by generate_layer(),
+    // while the G-code filters (spiral vase, cooling buffer, pressure equalizer) and the output into a file
+    // with the G-code analyzer and the time estimators are processed downstream, each stage in order on its own.
+    // The layers are prepared by prepare_layer() in parallel ahead of generate_layer().
+    void            process_layers(FILE *file, size_t num_layers,
+                        std::function<PreparedLayer(size_t)>                      prepare_layer,
+                        std::function<LayerResult(size_t, const PreparedLayer&)> generate_layer);
 
     void            set_last_pos(const Point &pos) { m_last_pos = pos; m_last_pos_defined = true; }
     bool            last_pos_defined() const { return m_last_pos_defined; }
     void            set_extruders(const std::vector<unsigned int> &extruder_ids);
     std::string     preamble();
     std::string     change_layer(coordf_t print_z);
-    std::string     extrude_entity(const ExtrusionEntity &entity, std::string description = "", double speed = -1., std::unique_ptr<EdgeGrid::Grid> *lower_layer_edge_grid = nullptr);
-    std::string     extrude_loop(ExtrusionLoop loop, std::string description, double speed = -1., std::unique_ptr<EdgeGrid::Grid> *lower_layer_edge_grid = nullptr);
+    std::string     extrude_entity(const ExtrusionEntity &entity, std::string description = "", double speed = -1., const EdgeGrid::Grid *lower_layer_edge_grid = nullptr);
+    std::string     extrude_loop(ExtrusionLoop loop, std::string description, double speed = -1., const EdgeGrid::Grid *lower_layer_edge_grid = nullptr);
     std::string     extrude_multi_path(ExtrusionMultiPath multipath, std::string description = "", double speed = -1.);
     std::string     extrude_path(ExtrusionPath path, std::string description = "", double speed = -1.);
 
@@ -252,7 +284,7 @@ protected:
     };
 
 
-    std::string     extrude_perimeters(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region, std::unique_ptr<EdgeGrid::Grid> &lower_layer_edge_grid);
+    std::string     extrude_perimeters(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region, const EdgeGrid::Grid *lower_layer_edge_grid);
     std::string     extrude_infill(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region);
     std::string     extrude_support(const ExtrusionEntityCollection &support_fills);
 
@@ -309,6 +341,9 @@ protected:
 
     std::unique_ptr<CoolingBuffer>      m_cooling_buffer;
     std::unique_ptr<SpiralVase>         m_spiral_vase;
+    // Shall the spiral vase be applied to the layer being generated? The flag is passed to m_spiral_vase with the layer G-code,
+    // as the spiral vase filter may still be processing the preceding layers.
+    bool                                m_spiral_vase_enable;
 #ifdef HAS_PRESSURE_EQUALIZER
     std::unique_ptr<PressureEqualizer>  m_pressure_equalizer;
 #endif /* HAS_PRESSURE_EQUALIZER */
@@ -337,6 +372,8 @@ protected:
     // Write a string into a file.
     void _write(FILE* file, const std::string& what) { this->_write(file, what.c_str()); }
     void _write(FILE* file, const char *what);
+    // Feeds the G-code into the analyzer (if enabled), which removes its tags from the G-code, and into the time estimators.
+    void _analyze(std::string &what);
 
     // Write a string into a file. 
     // Add a newline, if the string does not end with a newline already.
@@ -96,6 +96,26 @@ GCodeAnalyzer::GCodeMove::GCodeMove(GCodeMove::EType type, const GCodeAnalyzer::
 {
 }
 
+void GCodeAnalyzer::GCodeMovesStream::clear()
+{
+    types.clear();
+    metadata_ids.clear();
+    end_positions.clear();
+    deltas_extruder.clear();
+    start_positions.clear();
+    metadata.clear();
+}
+
+size_t GCodeAnalyzer::GCodeMovesStream::memory_used() const
+{
+    return SLIC3R_STDVEC_MEMSIZE(types, GCodeMove::EType) +
+        SLIC3R_STDVEC_MEMSIZE(metadata_ids, unsigned int) +
+        SLIC3R_STDVEC_MEMSIZE(end_positions, Vec3f) +
+        SLIC3R_STDVEC_MEMSIZE(deltas_extruder, float) +
+        SLIC3R_STDVEC_MEMSIZE(start_positions, StartPosition) +
+        SLIC3R_STDVEC_MEMSIZE(metadata, Metadata);
+}
+
 GCodeAnalyzer::GCodeAnalyzer()
 {
     reset();
@@ -122,21 +142,32 @@ void GCodeAnalyzer::reset()
     _set_start_extrusion(DEFAULT_START_EXTRUSION);
     _reset_axes_position();
 
-    m_moves_map.clear();
+    m_moves.clear();
     m_extruder_offsets.clear();
 }
 
-const std::string& GCodeAnalyzer::process_gcode(const std::string& gcode)
+const std::string& GCodeAnalyzer::process_gcode(const char *gcode)
 {
-    m_process_output = "";
+    m_process_output.clear();
 
-    m_parser.parse_buffer(gcode,
-        [this](GCodeReader& reader, const GCodeReader::GCodeLine& line)
-    { this->_process_gcode_line(reader, line); });
+    auto action = [this](GCodeReader& reader, const GCodeReader::GCodeLine& line)
+    { this->_process_gcode_line(reader, line); };
+    GCodeReader::GCodeLine gline;
+    while (*gcode != 0) {
+        gline.reset();
+        gcode = m_parser.parse_line(gcode, gline, action);
+    }
 
     return m_process_output;
 }
 
+void GCodeAnalyzer::process_gcode_in_place(std::string& gcode)
+{
+    this->process_gcode(gcode.c_str());
+    // The input buffer is reused for the output of the next call.
+    gcode.swap(m_process_output);
+}
+
 void GCodeAnalyzer::calc_gcode_preview_data(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
     // resets preview data
@@ -167,7 +198,8 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     {
 #if 0
         // DEBUG ONLY: puts the line back into the gcode
-        m_process_output += line.raw() + "\n";
+        m_process_output.append(line.raw().data(), line.raw().size());
+        m_process_output += '\n';
 #endif
         return;
     }
@@ -177,7 +209,7 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     _set_start_extrusion(_get_axis_position(E));
 
     // processes 'normal' gcode lines
-    std::string cmd = line.cmd();
+    const boost::string_view &cmd = line.cmd();
     if (cmd.length() > 1)
     {
         switch (::toupper(cmd[0]))
@@ -262,7 +294,8 @@ void GCodeAnalyzer::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLi
     }
 
     // puts the line back into the gcode
-    m_process_output += line.raw() + "\n";
+    m_process_output.append(line.raw().data(), line.raw().size());
+    m_process_output += '\n';
 }
 
 // Returns the new absolute position on the given axis in dependence of the given parameters
@@ -428,10 +461,10 @@ void GCodeAnalyzer::_processM600(const GCodeReader::GCodeLine& line)
 
 void GCodeAnalyzer::_processT(const GCodeReader::GCodeLine& line)
 {
-    std::string cmd = line.cmd();
+    const boost::string_view &cmd = line.cmd();
     if (cmd.length() > 1)
     {
-        unsigned int id = (unsigned int)::strtol(cmd.substr(1).c_str(), nullptr, 10);
+        unsigned int id = (unsigned int)::strtol(cmd.data() + 1, nullptr, 10);
         if (_get_extruder_id() != id)
         {
             _set_extruder_id(id);
@@ -444,7 +477,7 @@ void GCodeAnalyzer::_processT(const GCodeReader::GCodeLine& line)
 
 bool GCodeAnalyzer::_process_tags(const GCodeReader::GCodeLine& line)
 {
-    std::string comment = line.comment();
+    boost::string_view comment = line.comment();
 
     // extrusion role tag
     size_t pos = comment.find(Extrusion_Role_Tag);
@@ -481,9 +514,9 @@ bool GCodeAnalyzer::_process_tags(const GCodeReader::GCodeLine& line)
     return false;
 }
 
-void GCodeAnalyzer::_process_extrusion_role_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_extrusion_role_tag(const boost::string_view& comment, size_t pos)
 {
-    int role = (int)::strtol(comment.substr(pos + Extrusion_Role_Tag.length()).c_str(), nullptr, 10);
+    int role = (int)::strtol(comment.data() + pos + Extrusion_Role_Tag.length(), nullptr, 10);
     if (_is_valid_extrusion_role(role))
         _set_extrusion_role((ExtrusionRole)role);
     else
@@ -492,19 +525,19 @@ void GCodeAnalyzer::_process_extrusion_role_tag(const std::string& comment, size
     }
 }
 
-void GCodeAnalyzer::_process_mm3_per_mm_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_mm3_per_mm_tag(const boost::string_view& comment, size_t pos)
 {
-    _set_mm3_per_mm(::strtod(comment.substr(pos + Mm3_Per_Mm_Tag.length()).c_str(), nullptr));
+    _set_mm3_per_mm(::strtod(comment.data() + pos + Mm3_Per_Mm_Tag.length(), nullptr));
 }
 
-void GCodeAnalyzer::_process_width_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_width_tag(const boost::string_view& comment, size_t pos)
 {
-    _set_width((float)::strtod(comment.substr(pos + Width_Tag.length()).c_str(), nullptr));
+    _set_width((float)::strtod(comment.data() + pos + Width_Tag.length(), nullptr));
 }
 
-void GCodeAnalyzer::_process_height_tag(const std::string& comment, size_t pos)
+void GCodeAnalyzer::_process_height_tag(const boost::string_view& comment, size_t pos)
 {
-    _set_height((float)::strtod(comment.substr(pos + Height_Tag.length()).c_str(), nullptr));
+    _set_height((float)::strtod(comment.data() + pos + Height_Tag.length(), nullptr));
 }
 
 void GCodeAnalyzer::_set_units(GCodeAnalyzer::EUnits units)
@@ -654,21 +687,18 @@ Vec3d GCodeAnalyzer::_get_end_position() const
 
 void GCodeAnalyzer::_store_move(GCodeAnalyzer::GCodeMove::EType type)
 {
-    // if type non mapped yet, map it
-    TypeToMovesMap::iterator it = m_moves_map.find(type);
-    if (it == m_moves_map.end())
-        it = m_moves_map.insert(TypeToMovesMap::value_type(type, GCodeMovesList())).first;
+    // The positions are parsed as floats, they are stored without loss of precision.
+    Vec3f start_position = _get_start_position().cast<float>();
+    if (m_moves.end_positions.empty() || m_moves.end_positions.back() != start_position)
+        m_moves.start_positions.emplace_back(m_moves.size(), start_position);
 
-    // store move
-    Vec3d extruder_offset = Vec3d::Zero();
-    unsigned int extruder_id = _get_extruder_id();
-    ExtruderOffsetsMap::iterator extr_it = m_extruder_offsets.find(extruder_id);
-    if (extr_it != m_extruder_offsets.end())
-        extruder_offset = Vec3d(extr_it->second(0), extr_it->second(1), 0.0);
+    if (m_moves.metadata.empty() || (m_moves.metadata.back() != m_state.data))
+        m_moves.metadata.emplace_back(m_state.data);
 
-    Vec3d start_position = _get_start_position() + extruder_offset;
-    Vec3d end_position = _get_end_position() + extruder_offset;
-    it->second.emplace_back(type, _get_extrusion_role(), extruder_id, _get_mm3_per_mm(), _get_width(), _get_height(), _get_feedrate(), start_position, end_position, _get_delta_extrusion(), _get_cp_color_id());
+    m_moves.types.emplace_back(type);
+    m_moves.metadata_ids.emplace_back((unsigned int)m_moves.metadata.size() - 1);
+    m_moves.end_positions.emplace_back(_get_end_position().cast<float>());
+    m_moves.deltas_extruder.emplace_back(_get_delta_extrusion());
 }
 
 bool GCodeAnalyzer::_is_valid_extrusion_role(int value) const
@@ -676,6 +706,42 @@ bool GCodeAnalyzer::_is_valid_extrusion_role(int value) const
     return ((int)erNone <= value) && (value <= (int)erMixed);
 }
 
+template<typename Visitor>
+void GCodeAnalyzer::_visit_moves(GCodeMove::EType type, std::function<void()> &cancel_callback, Visitor visitor) const
+{
+    // to avoid to call the callback too often
+    size_t cancel_callback_threshold = std::max<size_t>(1, m_moves.size() / 25);
+
+    auto it_start_position = m_moves.start_positions.begin();
+    Vec3f start_position = Vec3f::Zero();
+    unsigned int metadata_id = (unsigned int)-1;
+    Vec3d extruder_offset = Vec3d::Zero();
+    for (size_t i = 0; i < m_moves.size(); ++ i)
+    {
+        if ((i + 1) % cancel_callback_threshold == 0)
+            cancel_callback();
+
+        if (it_start_position != m_moves.start_positions.end() && it_start_position->first == i)
+        {
+            start_position = it_start_position->second;
+            ++ it_start_position;
+        }
+
+        if (m_moves.types[i] == type)
+        {
+            if (metadata_id != m_moves.metadata_ids[i])
+            {
+                metadata_id = m_moves.metadata_ids[i];
+                ExtruderOffsetsMap::const_iterator extr_it = m_extruder_offsets.find(m_moves.metadata[metadata_id].extruder_id);
+                extruder_offset = (extr_it == m_extruder_offsets.end()) ? Vec3d::Zero() : Vec3d(extr_it->second(0), extr_it->second(1), 0.0);
+            }
+            visitor(GCodeMove(type, m_moves.metadata[metadata_id], start_position.cast<double>() + extruder_offset, m_moves.end_positions[i].cast<double>() + extruder_offset, m_moves.deltas_extruder[i]));
+        }
+
+        start_position = m_moves.end_positions[i];
+    }
+}
+
 void GCodeAnalyzer::_calc_gcode_preview_extrusion_layers(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
     struct Helper
@@ -711,10 +777,6 @@ void GCodeAnalyzer::_calc_gcode_preview_extrusion_layers(GCodePreviewData& previ
         }
     };
 
-    TypeToMovesMap::iterator extrude_moves = m_moves_map.find(GCodeMove::Extrude);
-    if (extrude_moves == m_moves_map.end())
-        return;
-
     Metadata data;
     float z = FLT_MAX;
     Polyline polyline;
@@ -725,18 +787,9 @@ void GCodeAnalyzer::_calc_gcode_preview_extrusion_layers(GCodePreviewData& previ
     GCodePreviewData::Range feedrate_range;
     GCodePreviewData::Range volumetric_rate_range;
 
-    // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)extrude_moves->second.size() / 25;
-    unsigned int cancel_callback_curr = 0;
-
     // constructs the polylines while traversing the moves
-    for (const GCodeMove& move : extrude_moves->second)
+    _visit_moves(GCodeMove::Extrude, cancel_callback, [&](const GCodeMove& move)
     {
-        // to avoid to call the callback too often
-        cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
-        if (cancel_callback_curr == 0)
-            cancel_callback();
-
         if ((data != move.data) || (z != move.start_position.z()) || (position != move.start_position) || (volumetric_rate != move.data.feedrate * (float)move.data.mm3_per_mm))
         {
             // store current polyline
@@ -765,7 +818,7 @@ void GCodeAnalyzer::_calc_gcode_preview_extrusion_layers(GCodePreviewData& previ
 
         // update current values
         position = move.end_position;
-    }
+    });
 
     // store last polyline
     polyline.remove_duplicate_points();
@@ -791,10 +844,6 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
         }
     };
 
-    TypeToMovesMap::iterator travel_moves = m_moves_map.find(GCodeMove::Move);
-    if (travel_moves == m_moves_map.end())
-        return;
-
     Polyline3 polyline;
     Vec3d position(FLT_MAX, FLT_MAX, FLT_MAX);
     GCodePreviewData::Travel::EType type = GCodePreviewData::Travel::Num_Types;
@@ -806,17 +855,9 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
     GCodePreviewData::Range width_range;
     GCodePreviewData::Range feedrate_range;
 
-    // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)travel_moves->second.size() / 25;
-    unsigned int cancel_callback_curr = 0;
-
     // constructs the polylines while traversing the moves
-    for (const GCodeMove& move : travel_moves->second)
+    _visit_moves(GCodeMove::Move, cancel_callback, [&](const GCodeMove& move)
     {
-        cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
-        if (cancel_callback_curr == 0)
-            cancel_callback();
-
         GCodePreviewData::Travel::EType move_type = (move.delta_extruder < 0.0f) ? GCodePreviewData::Travel::Retract : ((move.delta_extruder > 0.0f) ? GCodePreviewData::Travel::Extrude : GCodePreviewData::Travel::Move);
         GCodePreviewData::Travel::Polyline::EDirection move_direction = ((move.start_position.x() != move.end_position.x()) || (move.start_position.y() != move.end_position.y())) ? GCodePreviewData::Travel::Polyline::Generic : GCodePreviewData::Travel::Polyline::Vertical;
 
@@ -845,7 +886,7 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
         height_range.update_from(move.data.height);
         width_range.update_from(move.data.width);
         feedrate_range.update_from(move.data.feedrate);
-    }
+    });
 
     // store last polyline
     polyline.remove_duplicate_points();
@@ -859,54 +900,29 @@ void GCodeAnalyzer::_calc_gcode_preview_travel(GCodePreviewData& preview_data, s
 
 void GCodeAnalyzer::_calc_gcode_preview_retractions(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
-    TypeToMovesMap::iterator retraction_moves = m_moves_map.find(GCodeMove::Retract);
-    if (retraction_moves == m_moves_map.end())
-        return;
-
-    // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)retraction_moves->second.size() / 25;
-    unsigned int cancel_callback_curr = 0;
-
-    for (const GCodeMove& move : retraction_moves->second)
+    _visit_moves(GCodeMove::Retract, cancel_callback, [&](const GCodeMove& move)
     {
-        cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
-        if (cancel_callback_curr == 0)
-            cancel_callback();
-
         // store position
         Vec3crd position(scale_(move.start_position.x()), scale_(move.start_position.y()), scale_(move.start_position.z()));
         preview_data.retraction.positions.emplace_back(position, move.data.width, move.data.height);
-    }
+    });
 }
 
 void GCodeAnalyzer::_calc_gcode_preview_unretractions(GCodePreviewData& preview_data, std::function<void()> cancel_callback)
 {
-    TypeToMovesMap::iterator unretraction_moves = m_moves_map.find(GCodeMove::Unretract);
-    if (unretraction_moves == m_moves_map.end())
-        return;
-
-    // to avoid to call the callback too often
-    unsigned int cancel_callback_threshold = (unsigned int)unretraction_moves->second.size() / 25;
-    unsigned int cancel_callback_curr = 0;
-
-    for (const GCodeMove& move : unretraction_moves->second)
+    _visit_moves(GCodeMove::Unretract, cancel_callback, [&](const GCodeMove& move)
     {
-        cancel_callback_curr = (cancel_callback_curr + 1) % cancel_callback_threshold;
-        if (cancel_callback_curr == 0)
-            cancel_callback();
-
         // store position
         Vec3crd position(scale_(move.start_position.x()), scale_(move.start_position.y()), scale_(move.start_position.z()));
         preview_data.unretraction.positions.emplace_back(position, move.data.width, move.data.height);
-    }
+    });
 }
 
 // Return an estimate of the memory consumed by the time estimator.
 size_t GCodeAnalyzer::memory_used() const
 {
     size_t out = sizeof(*this);
-    for (const std::pair<GCodeMove::EType, GCodeMovesList> &kvp : m_moves_map)
-        out += sizeof(kvp) + SLIC3R_STDVEC_MEMSIZE(kvp.second, GCodeMove);
+    out += m_moves.memory_used();
     out += m_process_output.size();
     return out;
 }
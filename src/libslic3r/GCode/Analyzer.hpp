@@ -84,8 +84,26 @@ public:
         GCodeMove(EType type, const Metadata& data, const Vec3d& start_position, const Vec3d& end_position, float delta_extruder);
     };
 
-    typedef std::vector<GCodeMove> GCodeMovesList;
-    typedef std::map<GCodeMove::EType, GCodeMovesList> TypeToMovesMap;
+    // Moves in the order of the G-code, stored as a structure of arrays with the positions in single precision,
+    // as they are parsed from the G-code. The metadata changes rarely, it is stored once for a sequence of moves sharing it.
+    struct GCodeMovesStream
+    {
+        typedef std::pair<size_t, Vec3f> StartPosition;
+
+        std::vector<GCodeMove::EType>           types;
+        std::vector<unsigned int>               metadata_ids;
+        std::vector<Vec3f>                      end_positions;
+        std::vector<float>                      deltas_extruder;
+        // Start positions of the moves, which do not start at the end position of the previous move (after G92 for example),
+        // sorted by the index of the move.
+        std::vector<StartPosition>              start_positions;
+        std::vector<Metadata>                   metadata;
+
+        size_t size() const { return types.size(); }
+        void   clear();
+        size_t memory_used() const;
+    };
+
     typedef std::map<unsigned int, Vec2d> ExtruderOffsetsMap;
 
 private:
@@ -104,7 +122,7 @@ private:
 private:
     State m_state;
     GCodeReader m_parser;
-    TypeToMovesMap m_moves_map;
+    GCodeMovesStream m_moves;
     ExtruderOffsetsMap m_extruder_offsets;
 
     // The output of process_layer()
@@ -119,7 +137,12 @@ public:
     void reset();
 
     // Adds the gcode contained in the given string to the analysis and returns it after removing the workcodes
-    const std::string& process_gcode(const std::string& gcode);
+    const std::string& process_gcode(const std::string& gcode) { return this->process_gcode(gcode.c_str()); }
+    const std::string& process_gcode(const char *gcode);
+
+    // Same as above, the gcode is replaced by the gcode with the workcodes removed.
+    // The string buffers are swapped with the analyzer instead of being copied.
+    void process_gcode_in_place(std::string& gcode);
 
     // Calculates all data needed for gcode visualization
     // throws CanceledException through print->throw_if_canceled() (sent by the caller as callback).
@@ -175,16 +198,16 @@ private:
     bool _process_tags(const GCodeReader::GCodeLine& line);
 
     // Processes extrusion role tag
-    void _process_extrusion_role_tag(const std::string& comment, size_t pos);
+    void _process_extrusion_role_tag(const boost::string_view& comment, size_t pos);
 
     // Processes mm3_per_mm tag
-    void _process_mm3_per_mm_tag(const std::string& comment, size_t pos);
+    void _process_mm3_per_mm_tag(const boost::string_view& comment, size_t pos);
 
     // Processes width tag
-    void _process_width_tag(const std::string& comment, size_t pos);
+    void _process_width_tag(const boost::string_view& comment, size_t pos);
 
     // Processes height tag
-    void _process_height_tag(const std::string& comment, size_t pos);
+    void _process_height_tag(const boost::string_view& comment, size_t pos);
 
     void _set_units(EUnits units);
     EUnits _get_units() const;
@@ -238,6 +261,10 @@ private:
     // Checks if the given int is a valid extrusion role (contained into enum ExtrusionRole)
     bool _is_valid_extrusion_role(int value) const;
 
+    // Calls the visitor with the moves of the given type, in the order of the G-code, with the extruder offsets applied.
+    template<typename Visitor>
+    void _visit_moves(GCodeMove::EType type, std::function<void()> &cancel_callback, Visitor visitor) const;
+
     // All the following methods throw CanceledException through print->throw_if_canceled() (sent by the caller as callback).
     void _calc_gcode_preview_extrusion_layers(GCodePreviewData& preview_data, std::function<void()> cancel_callback);
     void _calc_gcode_preview_travel(GCodePreviewData& preview_data, std::function<void()> cancel_callback);
@@ -1,9 +1,10 @@
 #include "../GCode.hpp"
 #include "CoolingBuffer.hpp"
 #include <boost/algorithm/string/predicate.hpp>
-#include <boost/algorithm/string/replace.hpp>
+#include <boost/range/iterator_range_core.hpp>
 #include <iostream>
 #include <float.h>
+#include <string.h>
 
 #if 0
     #define DEBUG
@@ -49,7 +50,7 @@ struct CoolingLine
     };
 
     CoolingLine(unsigned int type, size_t  line_start, size_t  line_end) :
-        type(type), line_start(line_start), line_end(line_end),
+        type(type), line_start(line_start), line_end(line_end), feedrate_start(0), comment_start(line_end),
         length(0.f), feedrate(0.f), time(0.f), time_max(0.f), slowdown(false) {}
 
     bool adjustable(bool slowdown_external_perimeters) const {
@@ -67,6 +68,11 @@ struct CoolingLine
     size_t  line_start;
     // End of this line at the G-code snippet.
     size_t  line_end;
+    // Start of the value of the F word at the G-code snippet, zero if the line does not set the feedrate.
+    size_t  feedrate_start;
+    // Start of the comment (or of the trailing '\n') at the G-code snippet.
+    // Both positions are recorded by the parser, so that the G-code lines are not searched again when the slow down is applied.
+    size_t  comment_start;
     // XY Euclidian length of this segment.
     float   length;
     // Current feedrate, possibly adjusted.
@@ -310,8 +316,9 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
     const std::string toolchange_prefix = m_gcodegen.writer().toolchange_prefix();
     unsigned int      current_extruder  = m_current_extruder;
     PerExtruderAdjustments *adjustment  = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
-    const char       *line_start = gcode.c_str();
-    const char       *line_end   = line_start;
+    const char       *gcode_begin = gcode.c_str();
+    const char       *line_start  = gcode_begin;
+    const char       *line_end    = line_start;
     const char        extrusion_axis = config.get_extrusion_axis()[0];
     // Index of an existing CoolingLine of the current adjustment, which holds the feedrate setting command
     // for a sequence of extrusion moves.
@@ -319,29 +326,31 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
 
     for (; *line_start != 0; line_start = line_end) 
     {
+        // The line is decoded in place, it is not copied into a temporary string.
         while (*line_end != '\n' && *line_end != 0)
             ++ line_end;
-        // sline will not contain the trailing '\n'.
-        std::string sline(line_start, line_end);
+        // End of the line without the trailing '\n'.
+        const char *sline_end = line_end;
         // CoolingLine will contain the trailing '\n'.
         if (*line_end == '\n')
             ++ line_end;
-        CoolingLine line(0, line_start - gcode.c_str(), line_end - gcode.c_str());
-        if (boost::starts_with(sline, "G0 "))
+        CoolingLine line(0, line_start - gcode_begin, line_end - gcode_begin);
+        if (strncmp(line_start, "G0 ", 3) == 0)
             line.type = CoolingLine::TYPE_G0;
-        else if (boost::starts_with(sline, "G1 "))
+        else if (strncmp(line_start, "G1 ", 3) == 0)
             line.type = CoolingLine::TYPE_G1;
-        else if (boost::starts_with(sline, "G92 "))
+        else if (strncmp(line_start, "G92 ", 4) == 0)
             line.type = CoolingLine::TYPE_G92;
         if (line.type) {
             // G0, G1 or G92
             // Parse the G-code line.
-            std::vector<float> new_pos(current_pos);
-            const char *c = sline.data() + 3;
+            float new_pos[5];
+            std::copy(current_pos.begin(), current_pos.end(), new_pos);
+            const char *c = line_start + 3;
             for (;;) {
                 // Skip whitespaces.
                 for (; *c == ' ' || *c == '\t'; ++ c);
-                if (*c == 0 || *c == ';')
+                if (c == sline_end || *c == ';')
                     break;
                 // Parse the axis.
                 size_t axis = (*c >= 'X' && *c <= 'Z') ? (*c - 'X') :
@@ -351,23 +360,28 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     if (axis == 4) {
                         // Convert mm/min to mm/sec.
                         new_pos[4] /= 60.f;
-                        if ((line.type & CoolingLine::TYPE_G92) == 0)
+                        if ((line.type & CoolingLine::TYPE_G92) == 0) {
                             // This is G0 or G1 line and it sets the feedrate. This mark is used for reducing the duplicate F calls.
                             line.type |= CoolingLine::TYPE_HAS_F;
+                            line.feedrate_start = c - gcode_begin;
+                        }
                     }
                 }
-                // Skip this word.
-                for (; *c != ' ' && *c != '\t' && *c != 0; ++ c);
+                // Skip this word. The cooling markers may follow the last word without a space.
+                for (; *c != ' ' && *c != '\t' && *c != ';' && c != sline_end; ++ c);
             }
-            bool external_perimeter = boost::contains(sline, ";_EXTERNAL_PERIMETER");
-            bool wipe               = boost::contains(sline, ";_WIPE");
-            if (external_perimeter)
-                line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
-            if (wipe)
-                line.type |= CoolingLine::TYPE_WIPE;
-            if (boost::contains(sline, ";_EXTRUDE_SET_SPEED") && ! wipe) {
-                line.type |= CoolingLine::TYPE_ADJUSTABLE;
-                active_speed_modifier = adjustment->lines.size();
+            line.comment_start = c - gcode_begin;
+            // The cooling markers are emitted as G-code comments, search for them in the comment only.
+            if (*c == ';') {
+                boost::iterator_range<const char*> comment(c, sline_end);
+                if (boost::contains(comment, ";_EXTERNAL_PERIMETER"))
+                    line.type |= CoolingLine::TYPE_EXTERNAL_PERIMETER;
+                if (boost::contains(comment, ";_WIPE"))
+                    line.type |= CoolingLine::TYPE_WIPE;
+                if (boost::contains(comment, ";_EXTRUDE_SET_SPEED") && (line.type & CoolingLine::TYPE_WIPE) == 0) {
+                    line.type |= CoolingLine::TYPE_ADJUSTABLE;
+                    active_speed_modifier = adjustment->lines.size();
+                }
             }
             if ((line.type & CoolingLine::TYPE_G92) == 0) {
                 // G0 or G1. Calculate the duration.
@@ -410,30 +424,30 @@ std::vector<PerExtruderAdjustments> CoolingBuffer::parse_layer_gcode(const std::
                     line.type = 0;
                 }
             }
-            current_pos = std::move(new_pos);
-        } else if (boost::starts_with(sline, ";_EXTRUDE_END")) {
+            std::copy(new_pos, new_pos + 5, current_pos.begin());
+        } else if (strncmp(line_start, ";_EXTRUDE_END", 13) == 0) {
             line.type = CoolingLine::TYPE_EXTRUDE_END;
             active_speed_modifier = size_t(-1);
-        } else if (boost::starts_with(sline, toolchange_prefix)) {
+        } else if (strncmp(line_start, toolchange_prefix.data(), toolchange_prefix.size()) == 0) {
             // Switch the tool.
             line.type = CoolingLine::TYPE_SET_TOOL;
-            unsigned int new_extruder = (unsigned int)atoi(sline.c_str() + toolchange_prefix.size());
+            unsigned int new_extruder = (unsigned int)atoi(line_start + toolchange_prefix.size());
             if (new_extruder != current_extruder) {
                 current_extruder = new_extruder;
                 adjustment         = &per_extruder_adjustments[map_extruder_to_per_extruder_adjustment[current_extruder]];
             }
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_START")) {
+        } else if (strncmp(line_start, ";_BRIDGE_FAN_START", 18) == 0) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_START;
-        } else if (boost::starts_with(sline, ";_BRIDGE_FAN_END")) {
+        } else if (strncmp(line_start, ";_BRIDGE_FAN_END", 16) == 0) {
             line.type = CoolingLine::TYPE_BRIDGE_FAN_END;
-        } else if (boost::starts_with(sline, "G4 ")) {
-            // Parse the wait time.
+        } else if (strncmp(line_start, "G4 ", 3) == 0) {
+            // Parse the wait time, either in seconds (S) or in milliseconds (P). Don't look into the comment.
             line.type = CoolingLine::TYPE_G4;
-            size_t pos_S = sline.find('S', 3);
-            size_t pos_P = sline.find('P', 3);
+            const char *c = line_start + 3;
+            for (; c != sline_end && *c != ';' && *c != 'S' && *c != 'P'; ++ c);
             line.time = line.time_max = float(
-                (pos_S > 0) ? atof(sline.c_str() + pos_S + 1) :
-                (pos_P > 0) ? atof(sline.c_str() + pos_P + 1) * 0.001 : 0.);
+                (c == sline_end || *c == ';') ? 0. :
+                (*c == 'S') ? atof(c + 1) : atof(c + 1) * 0.001);
         }
         if (line.type != 0)
             adjustment->lines.emplace_back(std::move(line));
@@ -637,6 +651,32 @@ float CoolingBuffer::calculate_layer_slowdown(std::vector<PerExtruderAdjustments
     return elapsed_time_total0;
 }
 
+// Append a G-code comment to the output, leave out the cooling markers consumed by the CoolingBuffer.
+static inline void append_comment_without_cooling_markers(std::string &out, const char *begin, const char *end)
+{
+    static const char *markers[] = { ";_EXTRUDE_SET_SPEED", ";_EXTERNAL_PERIMETER", ";_WIPE" };
+    const char *copy_from = begin;
+    for (const char *c = begin; c != end;) {
+        size_t marker_len = 0;
+        if (*c == ';')
+            for (const char *marker : markers) {
+                size_t len = strlen(marker);
+                if (size_t(end - c) >= len && strncmp(c, marker, len) == 0) {
+                    marker_len = len;
+                    break;
+                }
+            }
+        if (marker_len == 0) {
+            ++ c;
+        } else {
+            out.append(copy_from, c - copy_from);
+            c += marker_len;
+            copy_from = c;
+        }
+    }
+    out.append(copy_from, end - copy_from);
+}
+
 // Apply slow down over G-code lines stored in per_extruder_adjustments, enable fan if needed.
 // Returns the adjusted G-code.
 std::string CoolingBuffer::apply_layer_cooldown(
@@ -726,14 +766,12 @@ std::string CoolingBuffer::apply_layer_cooldown(
         } else if (line->type & CoolingLine::TYPE_EXTRUDE_END) {
             // Just remove this comment.
         } else if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE | CoolingLine::TYPE_HAS_F)) {
-            // Find the start of a comment, or roll to the end of line.
-            const char *end = line_start;
-            for (; end < line_end && *end != ';'; ++ end);
-            // Find the 'F' word.
-            const char *fpos            = strstr(line_start + 2, " F") + 2;
+            // The start of the comment and the value of the 'F' word were recorded by parse_layer_gcode().
+            const char *end             = gcode.c_str() + line->comment_start;
+            const char *fpos            = gcode.c_str() + line->feedrate_start;
             int         new_feedrate    = current_feedrate;
             bool        modify          = false;
-            assert(fpos != nullptr);
+            assert(line->feedrate_start > line->line_start);
             if (line->slowdown) {
                 modify       = true;
                 new_feedrate = int(floor(60. * line->feedrate + 0.5));
@@ -779,13 +817,7 @@ std::string CoolingBuffer::apply_layer_cooldown(
             if (end < line_end) {
                 if (line->type & (CoolingLine::TYPE_ADJUSTABLE | CoolingLine::TYPE_EXTERNAL_PERIMETER | CoolingLine::TYPE_WIPE)) {
                     // Process comments, remove ";_EXTRUDE_SET_SPEED", ";_EXTERNAL_PERIMETER", ";_WIPE"
-                    std::string comment(end, line_end);
-                    boost::replace_all(comment, ";_EXTRUDE_SET_SPEED", "");
-                    if (line->type & CoolingLine::TYPE_EXTERNAL_PERIMETER)
-                        boost::replace_all(comment, ";_EXTERNAL_PERIMETER", "");
-                    if (line->type & CoolingLine::TYPE_WIPE)
-                        boost::replace_all(comment, ";_WIPE", "");
-                    new_gcode += comment;
+                    append_comment_without_cooling_markers(new_gcode, end, line_end);
                 } else {
                     // Just attach the rest of the source line.
                     new_gcode.append(end, line_end - end);
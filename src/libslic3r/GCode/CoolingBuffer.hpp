@@ -20,6 +20,10 @@ struct PerExtruderAdjustments;
 // For example, some materials may not like to print too slowly, while with some materials 
 // we may slow down significantly.
 //
+// The layers are processed by GCode::process_layers() concurrently with the generation of the following layers.
+// Therefore only the print config, the extruder IDs and the fan state of the GCodeWriter are accessed through m_gcodegen,
+// as these are not modified by the G-code generator while the layers are being exported.
+//
 class CoolingBuffer {
 public:
     CoolingBuffer(GCode &gcodegen);
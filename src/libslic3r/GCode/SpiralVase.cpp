@@ -51,13 +51,13 @@ std::string SpiralVase::process_layer(const std::string &gcode)
     
     std::string new_gcode;
     this->_reader.parse_buffer(gcode, [&new_gcode, &z, &layer_height, &total_layer_length]
-        (GCodeReader &reader, GCodeReader::GCodeLine line) {
+        (GCodeReader &reader, const GCodeReader::GCodeLine &line) {
         if (line.cmd_is("G1")) {
             if (line.has_z()) {
                 // If this is the initial Z move of the layer, replace it with a
                 // (redundant) move to the last Z of previous layer.
-                line.set(reader, Z, z);
-                new_gcode += line.raw() + '\n';
+                line.append_with_axis(new_gcode, reader, Z, z);
+                new_gcode += '\n';
                 return;
             } else {
                 float dist_XY = line.dist_XY(reader);
@@ -65,8 +65,8 @@ std::string SpiralVase::process_layer(const std::string &gcode)
                     // horizontal move
                     if (line.extruding(reader)) {
                         z += dist_XY * layer_height / total_layer_length;
-                        line.set(reader, Z, z);
-                        new_gcode += line.raw() + '\n';
+                        line.append_with_axis(new_gcode, reader, Z, z);
+                        new_gcode += '\n';
                     }
                     return;
                 
@@ -78,7 +78,8 @@ std::string SpiralVase::process_layer(const std::string &gcode)
                 }
             }
         }
-        new_gcode += line.raw() + '\n';
+        new_gcode.append(line.raw().data(), line.raw().size());
+        new_gcode += '\n';
     });
     
     return new_gcode;
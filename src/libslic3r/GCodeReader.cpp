@@ -1,9 +1,12 @@
 #include "GCodeReader.hpp"
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
-#include <fstream>
+#include <boost/nowide/cstdio.hpp>
+#include <cstdio>
 #include <iostream>
-#include <iomanip>
+#include <vector>
+
+#include <tbb/parallel_for.h>
 
 #include <Shiny/Shiny.h>
 
@@ -21,18 +24,17 @@ void GCodeReader::apply_config(const DynamicPrintConfig &config)
     m_extrusion_axis = m_config.get_extrusion_axis()[0];
 }
 
-const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline, std::pair<const char*, const char*> &command)
+const char* GCodeReader::decode_line(const char *ptr, GCodeLine &gline) const
 {
-    PROFILE_FUNC();
-    
+    // No profiling blocks here, the lines are decoded by multiple threads by parse_file().
     // command and args
     const char *c = ptr;
     {
-        PROFILE_BLOCK(command_and_args);
         // Skip the whitespaces.
-        command.first = skip_whitespaces(c);
+        const char *cmd = skip_whitespaces(c);
         // Skip the command.
-        c = command.second = skip_word(command.first);
+        c = skip_word(cmd);
+        gline.m_cmd = boost::string_view(cmd, c - cmd);
         // Up to the end of line or comment.
 		while (! is_end_of_gcode_line(*c)) {
             // Skip whitespaces.
@@ -68,18 +70,12 @@ const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline,
                 c = skip_word(c);
         }
     }
-    
-    if (gline.has(E) && m_config.use_relative_e_distances)
-        m_position[E] = 0;
 
     // Skip the rest of the line.
     for (; ! is_end_of_line(*c); ++ c);
 
-    // Copy the raw string including the comment, without the trailing newlines.
-    if (c > ptr) {
-        PROFILE_BLOCK(copy_raw_string);
-        gline.m_raw.assign(ptr, c);
-    }
+    // Reference the raw string including the comment, without the trailing newlines.
+    gline.m_raw = boost::string_view(ptr, c - ptr);
 
     // Skip the trailing newlines.
 	if (*c == '\r')
@@ -87,19 +83,25 @@ const char* GCodeReader::parse_line_internal(const char *ptr, GCodeLine &gline,
 	if (*c == '\n')
 		++ c;
 
-    if (m_verbose)
-        std::cout << gline.m_raw << std::endl;
-
     return c;
 }
 
-void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command)
+void GCodeReader::start_line(const GCodeLine &gline)
+{
+    if (gline.has(E) && m_config.use_relative_e_distances)
+        m_position[E] = 0;
+
+    if (m_verbose)
+        std::cout << gline.raw() << std::endl;
+}
+
+void GCodeReader::update_coordinates(const GCodeLine &gline)
 {
     PROFILE_FUNC();
-    if (*command.first == 'G') {
-        int cmd_len = int(command.second - command.first);
-        if ((cmd_len == 2 && (command.first[1] == '0' || command.first[1] == '1')) ||
-            (cmd_len == 3 &&  command.first[1] == '9' && command.first[2] == '2')) {
+    const boost::string_view &cmd = gline.cmd();
+    if (! cmd.empty() && cmd[0] == 'G') {
+        if ((cmd.size() == 2 && (cmd[1] == '0' || cmd[1] == '1')) ||
+            (cmd.size() == 3 &&  cmd[1] == '9' && cmd[2] == '2')) {
             for (size_t i = 0; i < NUM_AXES; ++ i)
                 if (gline.has(Axis(i)))
                     m_position[i] = gline.value(Axis(i));
@@ -109,19 +111,82 @@ void GCodeReader::update_coordinates(GCodeLine &gline, std::pair<const char*, co
 
 void GCodeReader::parse_file(const std::string &file, callback_t callback)
 {
-    std::ifstream f(file);
-    std::string line;
-    while (std::getline(f, line))
-        this->parse_line(line, callback);
+    // Size of the blocks the file is read by.
+    static const size_t File_Block_Size  = 4 * 1024 * 1024;
+    // Approximate size of the chunks of a block decoded by a single thread.
+    static const size_t File_Chunk_Size  = 64 * 1024;
+
+    PROFILE_FUNC();
+    FILE *f = boost::nowide::fopen(file.c_str(), "rb");
+    if (f == nullptr)
+        return;
+
+    std::vector<char>                   buffer;
+    std::vector<const char*>            chunks;
+    std::vector<std::vector<GCodeLine>> chunk_lines;
+    // Length of the incomplete last line of the previous block, which has been moved to the start of the buffer.
+    size_t                              num_leftover = 0;
+    for (bool eof = false; ! eof;) {
+        buffer.resize(num_leftover + File_Block_Size + 1);
+        size_t num_read  = fread(buffer.data() + num_leftover, 1, File_Block_Size, f);
+        size_t data_end  = num_leftover + num_read;
+        eof = num_read < File_Block_Size;
+        // Only the complete lines are decoded, the incomplete last line is decoded with the next block.
+        size_t block_end = data_end;
+        if (eof)
+            // Zero terminate the last line, which may not end with a new line.
+            buffer[data_end] = 0;
+        else {
+            for (; block_end > 0 && buffer[block_end - 1] != '\n'; -- block_end) ;
+            if (block_end == 0) {
+                // Not a single complete line in the buffer. Read more.
+                num_leftover = data_end;
+                continue;
+            }
+        }
+
+        // Split the block into chunks at the line boundaries, decode the chunks in parallel.
+        const char *begin = buffer.data();
+        const char *end   = begin + block_end;
+        chunks.clear();
+        for (const char *ptr = begin; ptr < end;) {
+            chunks.emplace_back(ptr);
+            ptr = (size_t(end - ptr) > File_Chunk_Size) ? ptr + File_Chunk_Size : end;
+            for (; ptr < end && ptr[-1] != '\n'; ++ ptr) ;
+        }
+        chunks.emplace_back(end);
+        if (chunk_lines.size() < chunks.size() - 1)
+            chunk_lines.resize(chunks.size() - 1);
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, chunks.size() - 1),
+            [this, &chunks, &chunk_lines](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i) {
+                    std::vector<GCodeLine> &lines = chunk_lines[i];
+                    lines.clear();
+                    for (const char *ptr = chunks[i]; ptr < chunks[i + 1];) {
+                        lines.emplace_back();
+                        ptr = this->decode_line(ptr, lines.back());
+                    }
+                }
+            });
+
+        // Process the decoded lines in order.
+        for (size_t i = 0; i + 1 < chunks.size(); ++ i)
+            for (const GCodeLine &gline : chunk_lines[i])
+                this->process_decoded_line(gline, callback);
+
+        // Move the incomplete last line to the start of the buffer.
+        num_leftover = data_end - block_end;
+        if (num_leftover > 0)
+            memmove(buffer.data(), buffer.data() + block_end, num_leftover);
+    }
+
+    fclose(f);
 }
 
 bool GCodeReader::GCodeLine::has(char axis) const
 {
-    const char *c = m_raw.c_str();
-    // Skip the whitespaces.
-    c = skip_whitespaces(c);
-    // Skip the command.
-    c = skip_word(c);
+    // The raw line is followed by an end of line or a zero in the G-code being parsed.
+    const char *c = m_cmd.data() + m_cmd.size();
     // Up to the end of line or comment.
     while (! is_end_of_gcode_line(*c)) {
         // Skip whitespaces.
@@ -139,11 +204,8 @@ bool GCodeReader::GCodeLine::has(char axis) const
 
 bool GCodeReader::GCodeLine::has_value(char axis, float &value) const
 {
-    const char *c = m_raw.c_str();
-    // Skip the whitespaces.
-    c = skip_whitespaces(c);
-    // Skip the command.
-    c = skip_word(c);
+    // The raw line is followed by an end of line or a zero in the G-code being parsed.
+    const char *c = m_cmd.data() + m_cmd.size();
     // Up to the end of line or comment.
     while (! is_end_of_gcode_line(*c)) {
         // Skip whitespaces.
@@ -167,10 +229,10 @@ bool GCodeReader::GCodeLine::has_value(char axis, float &value) const
     return false;
 }
 
-void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, const float new_value, const int decimal_digits)
+void GCodeReader::GCodeLine::append_with_axis(std::string &out, const GCodeReader &reader, const Axis axis, const float new_value, const int decimal_digits) const
 {
-    std::ostringstream ss;
-    ss << std::fixed << std::setprecision(decimal_digits) << new_value;
+    char value[64];
+    sprintf(value, "%.*f", decimal_digits, new_value);
 
     char match[3] = " X";
     if (int(axis) < 3)
@@ -183,18 +245,23 @@ void GCodeReader::GCodeLine::set(const GCodeReader &reader, const Axis axis, con
     }
 
     if (this->has(axis)) {
+        // Replace the value of the axis up to the next space, or up to the end of the line.
         size_t pos = m_raw.find(match)+2;
         size_t end = m_raw.find(' ', pos+1);
-        m_raw = m_raw.replace(pos, end-pos, ss.str());
+        out.append(m_raw.data(), pos);
+        out += value;
+        if (end != boost::string_view::npos)
+            out.append(m_raw.data() + end, m_raw.size() - end);
     } else {
+        // Insert the axis after the command.
         size_t pos = m_raw.find(' ');
-        if (pos == std::string::npos)
-            m_raw += std::string(match) + ss.str();
-        else
-            m_raw = m_raw.replace(pos, 0, std::string(match) + ss.str());
+        if (pos == boost::string_view::npos)
+            pos = m_raw.size();
+        out.append(m_raw.data(), pos);
+        out += match;
+        out += value;
+        out.append(m_raw.data() + pos, m_raw.size() - pos);
     }
-    m_axis[axis] = new_value;
-    m_mask |= 1 << int(axis);
 }
 
 }
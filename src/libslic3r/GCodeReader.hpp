@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <functional>
 #include <string>
+#include <boost/utility/string_view.hpp>
 #include "PrintConfig.hpp"
 
 namespace Slic3r {
@@ -15,15 +16,14 @@ public:
     class GCodeLine {
     public:
         GCodeLine() { reset(); }
-        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw.clear(); }
+        void reset() { m_mask = 0; memset(m_axis, 0, sizeof(m_axis)); m_raw = m_cmd = boost::string_view("", 0); }
 
-        const std::string&  raw() const { return m_raw; }
-        const std::string   cmd() const { 
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
-            return std::string(cmd, GCodeReader::skip_word(cmd));
-        }
-        const std::string   comment() const
-            { size_t pos = m_raw.find(';'); return (pos == std::string::npos) ? "" : m_raw.substr(pos + 1); }
+        // The raw line (without the trailing new line), the command and the comment are views into the G-code being parsed,
+        // they are not copied. Thus they are only valid while the callback processing this line is being executed.
+        const boost::string_view& raw() const { return m_raw; }
+        const boost::string_view& cmd() const { return m_cmd; }
+        boost::string_view        comment() const
+            { size_t pos = m_raw.find(';'); return (pos == boost::string_view::npos) ? boost::string_view("", 0) : m_raw.substr(pos + 1); }
 
         bool  has(Axis axis) const { return (m_mask & (1 << int(axis))) != 0; }
         float value(Axis axis) const { return m_axis[axis]; }
@@ -42,14 +42,15 @@ public:
             return sqrt(x*x + y*y);
         }
         bool cmd_is(const char *cmd_test) const {
-            const char *cmd = GCodeReader::skip_whitespaces(m_raw.c_str());
             size_t len = strlen(cmd_test); 
-            return strncmp(cmd, cmd_test, len) == 0 && GCodeReader::is_end_of_word(cmd[len]);
+            return m_cmd.size() == len && strncmp(m_cmd.data(), cmd_test, len) == 0;
         }
         bool extruding(const GCodeReader &reader)  const { return this->cmd_is("G1") && this->dist_E(reader) > 0; }
         bool retracting(const GCodeReader &reader) const { return this->cmd_is("G1") && this->dist_E(reader) < 0; }
         bool travel()     const { return this->cmd_is("G1") && ! this->has(E); }
-        void set(const GCodeReader &reader, const Axis axis, const float new_value, const int decimal_digits = 3);
+        // Append the raw line to out with the value of the axis replaced by new_value, or with the axis inserted after the command.
+        // The line is not modified, it only references the G-code being parsed.
+        void append_with_axis(std::string &out, const GCodeReader &reader, const Axis axis, const float new_value, const int decimal_digits = 3) const;
 
         bool  has_x() const { return this->has(X); }
         bool  has_y() const { return this->has(Y); }
@@ -63,7 +64,8 @@ public:
         float f() const { return m_axis[F]; }
 
     private:
-        std::string      m_raw;
+        boost::string_view m_raw;
+        boost::string_view m_cmd;
         float            m_axis[NUM_AXES];
         uint32_t         m_mask;
         friend class GCodeReader;
@@ -92,10 +94,8 @@ public:
     template<typename Callback>
     const char* parse_line(const char *ptr, GCodeLine &gline, Callback &callback)
     {
-        std::pair<const char*, const char*> cmd;
-        const char *end = parse_line_internal(ptr, gline, cmd);
-        callback(*this, gline);
-        update_coordinates(gline, cmd);
+        const char *end = decode_line(ptr, gline);
+        this->process_decoded_line(gline, callback);
         return end;
     }
 
@@ -103,6 +103,8 @@ public:
     void parse_line(const std::string &line, Callback callback)
         { GCodeLine gline; this->parse_line(line.c_str(), gline, callback); }
 
+    // The file is read in large blocks and the lines of each block are decoded in parallel,
+    // while the callback is called for the decoded lines serially in the order of the file.
     void parse_file(const std::string &file, callback_t callback);
 
     float& x()       { return m_position[X]; }
@@ -119,8 +121,18 @@ public:
     char   extrusion_axis() const { return m_extrusion_axis; }
 
 private:
-    const char* parse_line_internal(const char *ptr, GCodeLine &gline, std::pair<const char*, const char*> &command);
-    void        update_coordinates(GCodeLine &gline, std::pair<const char*, const char*> &command);
+    // Decode the command and the axis values of a single line, return the start of the next line.
+    // The reader is not modified, therefore multiple lines may be decoded in parallel.
+    const char* decode_line(const char *ptr, GCodeLine &gline) const;
+    template<typename Callback>
+    void        process_decoded_line(const GCodeLine &gline, Callback &callback)
+    {
+        this->start_line(gline);
+        callback(*this, gline);
+        this->update_coordinates(gline);
+    }
+    void        start_line(const GCodeLine &gline);
+    void        update_coordinates(const GCodeLine &gline);
 
     static bool         is_whitespace(char c)           { return c == ' ' || c == '\t'; }
     static bool         is_end_of_line(char c)          { return c == '\r' || c == '\n' || c == 0; }
@@ -174,6 +174,7 @@ namespace Slic3r {
 
     GCodeTimeEstimator::GCodeTimeEstimator(EMode mode)
         : _mode(mode)
+        , _time_checkpoints_interval(0.0f)
     {
         reset();
         set_default();
@@ -199,14 +200,28 @@ namespace Slic3r {
         }
     }
 
-    void GCodeTimeEstimator::calculate_time(bool start_from_beginning)
+    void GCodeTimeEstimator::add_gcode_block(const char *ptr, GCodeTimeEstimator * const *estimators, size_t num_estimators)
     {
         PROFILE_FUNC();
-        if (start_from_beginning)
+        if (num_estimators == 0)
+            return;
+        GCodeReader::GCodeLine gline;
+        auto action = [estimators, num_estimators](GCodeReader &reader, const GCodeReader::GCodeLine &line)
         {
-            _reset_time();
-            _last_st_synchronized_block_id = -1;
+            for (size_t i = 0; i < num_estimators; ++ i)
+                estimators[i]->_process_gcode_line(reader, line);
+        };
+        // The estimators only use the decoded line, the parser state of the first estimator is used for parsing.
+        GCodeReader &parser = estimators[0]->_parser;
+        for (; *ptr != 0;) {
+            gline.reset();
+            ptr = parser.parse_line(ptr, gline, action);
         }
+    }
+
+    void GCodeTimeEstimator::calculate_time()
+    {
+        PROFILE_FUNC();
         _calculate_time();
 
 #if ENABLE_MOVE_STATS
@@ -257,6 +272,11 @@ namespace Slic3r {
     }
 
     bool GCodeTimeEstimator::post_process_remaining_times(const std::string& filename, float interval)
+    {
+        return post_process_remaining_times(filename, interval, { this });
+    }
+
+    bool GCodeTimeEstimator::post_process_remaining_times(const std::string& filename, float interval, const std::vector<const GCodeTimeEstimator*>& estimators)
     {
         boost::nowide::ifstream in(filename);
         if (!in.good())
@@ -268,30 +288,50 @@ namespace Slic3r {
         if (out == nullptr)
             throw std::runtime_error(std::string("Remaining times export failed.\nCannot open file for writing.\n"));
 
-        std::string time_mask;
-        switch (_mode)
-        {
-        default:
-        case Normal:
+        // State of the export of the remaining times of a single estimator.
+        struct RemainingTimesExport
         {
-            time_mask = "M73 P%s R%s\n";
-            break;
-        }
-        case Silent:
+            const GCodeTimeEstimator                    *estimator;
+            const std::string                           *placeholder_tag;
+            const char                                  *time_mask;
+            TimeCheckpointsList::const_iterator          it_checkpoint;
+            float                                        last_recorded_time;
+        };
+        std::vector<RemainingTimesExport> exports;
+        for (const GCodeTimeEstimator *estimator : estimators)
         {
-            time_mask = "M73 Q%s S%s\n";
-            break;
-        }
+            RemainingTimesExport exp;
+            exp.estimator = estimator;
+            switch (estimator->_mode)
+            {
+            default:
+            case Normal:
+            {
+                exp.placeholder_tag = &Normal_First_M73_Output_Placeholder_Tag;
+                exp.time_mask = "M73 P%s R%s\n";
+                break;
+            }
+            case Silent:
+            {
+                exp.placeholder_tag = &Silent_First_M73_Output_Placeholder_Tag;
+                exp.time_mask = "M73 Q%s S%s\n";
+                break;
+            }
+            }
+            exp.it_checkpoint = estimator->_time_checkpoints.begin();
+            exp.last_recorded_time = 0.0f;
+            exports.emplace_back(exp);
         }
 
+        // The remaining times of all the estimators are inserted in a single pass over the file.
+        // The M73 lines are emitted in the same order as if the file was processed by the estimators one after the other.
+        GCodeReader parser;
         unsigned int g1_lines_count = 0;
-        float last_recorded_time = 0.0f;
         std::string gcode_line;
         // buffer line to export only when greater than 64K to reduce writing calls
         std::string export_line;
         char time_line[64];
-		G1LineIdToBlockIdMap::const_iterator it_line_id = _g1_line_ids.begin();
-		while (std::getline(in, gcode_line))
+        while (std::getline(in, gcode_line))
         {
             if (!in.good())
             {
@@ -300,46 +340,51 @@ namespace Slic3r {
             }
 
             // replaces placeholders for initial line M73 with the real lines
-            if (((_mode == Normal) && (gcode_line == Normal_First_M73_Output_Placeholder_Tag)) ||
-                ((_mode == Silent) && (gcode_line == Silent_First_M73_Output_Placeholder_Tag)))
-            {
-                sprintf(time_line, time_mask.c_str(), "0", _get_time_minutes(_time).c_str());
-                gcode_line = time_line;
-            }
-            else
-               gcode_line += "\n";
+            bool placeholder = false;
+            for (const RemainingTimesExport &exp : exports)
+                if (gcode_line == *exp.placeholder_tag)
+                {
+                    sprintf(time_line, exp.time_mask, "0", _get_time_minutes(exp.estimator->_time).c_str());
+                    export_line += time_line;
+                    placeholder = true;
+                    break;
+                }
+            if (placeholder)
+                continue;
+
+            export_line += gcode_line;
+            export_line += "\n";
 
             // add remaining time lines where needed
-            _parser.parse_line(gcode_line,
-                [this, &it_line_id, &g1_lines_count, &last_recorded_time, &time_line, &gcode_line, time_mask, interval](GCodeReader& reader, const GCodeReader::GCodeLine& line)
+            parser.parse_line(gcode_line,
+                [&exports, &g1_lines_count, &time_line, &export_line, interval](GCodeReader& reader, const GCodeReader::GCodeLine& line)
             {
                 if (line.cmd_is("G1"))
                 {
                     ++g1_lines_count;
-
-					assert(it_line_id == _g1_line_ids.end() || it_line_id->first >= g1_lines_count);
-
-					const Block *block = nullptr;
-					if (it_line_id != _g1_line_ids.end() && it_line_id->first == g1_lines_count) {
-						if (line.has_e() && it_line_id->second < (unsigned int)_blocks.size())
-							block = &_blocks[it_line_id->second];
-						++it_line_id;
-					}
-
-					if (block != nullptr && block->elapsed_time != -1.0f) {
-                        float block_remaining_time = _time - block->elapsed_time;
-                        if (std::abs(last_recorded_time - block_remaining_time) > interval)
-                        {
-                            sprintf(time_line, time_mask.c_str(), std::to_string((int)(100.0f * block->elapsed_time / _time)).c_str(), _get_time_minutes(block_remaining_time).c_str());
-                            gcode_line += time_line;
-
-                            last_recorded_time = block_remaining_time;
+                    for (auto it_exp = exports.rbegin(); it_exp != exports.rend(); ++ it_exp)
+                    {
+                        RemainingTimesExport     &exp       = *it_exp;
+                        const GCodeTimeEstimator &estimator = *exp.estimator;
+
+                        assert(exp.it_checkpoint == estimator._time_checkpoints.end() || exp.it_checkpoint->g1_line_id >= g1_lines_count);
+
+                        if (exp.it_checkpoint != estimator._time_checkpoints.end() && exp.it_checkpoint->g1_line_id == g1_lines_count) {
+                            float elapsed_time = exp.it_checkpoint->elapsed_time;
+                            ++exp.it_checkpoint;
+                            float block_remaining_time = estimator._time - elapsed_time;
+                            if (std::abs(exp.last_recorded_time - block_remaining_time) > interval)
+                            {
+                                sprintf(time_line, exp.time_mask, std::to_string((int)(100.0f * elapsed_time / estimator._time)).c_str(), _get_time_minutes(block_remaining_time).c_str());
+                                export_line += time_line;
+
+                                exp.last_recorded_time = block_remaining_time;
+                            }
                         }
                     }
                 }
             });
 
-            export_line += gcode_line;
             if (export_line.length() > 65535)
             {
                 fwrite((const void*)export_line.c_str(), 1, export_line.length(), out);
@@ -591,6 +636,11 @@ namespace Slic3r {
         return _state.extruder_id;
     }
 
+    void GCodeTimeEstimator::set_remaining_times_interval(float interval_sec)
+    {
+        _time_checkpoints_interval = interval_sec;
+    }
+
     void GCodeTimeEstimator::reset_extruder_id()
     {
         // Set the initial extruder ID to unknown. For the multi-material setup it means
@@ -674,6 +724,7 @@ namespace Slic3r {
         size_t out = sizeof(*this);
 		out += SLIC3R_STDVEC_MEMSIZE(this->_blocks, Block);
 		out += SLIC3R_STDVEC_MEMSIZE(this->_g1_line_ids, G1LineIdToBlockId);
+		out += SLIC3R_STDVEC_MEMSIZE(this->_time_checkpoints, TimeCheckpoint);
         return out;
     }
 
@@ -685,14 +736,18 @@ namespace Slic3r {
         set_axis_position(X, 0.0f);
         set_axis_position(Y, 0.0f);
         set_axis_position(Z, 0.0f);
+        set_axis_position(E, 0.0f);
 
         set_additional_time(0.0f);
 
         reset_extruder_id();
         reset_g1_line_id();
         _g1_line_ids.clear();
+        _time_checkpoints.clear();
 
         _last_st_synchronized_block_id = -1;
+        _last_nominal_length_block_id = -1;
+        _nominal_length_scan_id = 0;
     }
 
     void GCodeTimeEstimator::_reset_time()
@@ -709,13 +764,73 @@ namespace Slic3r {
     void GCodeTimeEstimator::_calculate_time()
     {
         PROFILE_FUNC();
-        _forward_pass();
-        _reverse_pass();
-        _recalculate_trapezoids();
+        int begin = _last_st_synchronized_block_id + 1;
+        int end = (int)_blocks.size();
+        _forward_pass(begin, end);
+        _reverse_pass(begin, end);
+        _recalculate_trapezoids(begin, end);
+
+        _accumulate_time(begin, end);
 
+        // The additional time (dwell, tool change) is spent after the moves preceding the st_synchronize have finished,
+        // therefore it is added after their elapsed times were recorded. This way the elapsed times do not depend
+        // on whether the blocks were finalized by _finalize_planned_blocks() before the additional time was known.
         _time += get_additional_time();
 
-        for (int i = _last_st_synchronized_block_id + 1; i < (int)_blocks.size(); ++i)
+        _last_st_synchronized_block_id = end - 1;
+        // The additional time has been consumed (added to the total time), reset it to zero.
+        set_additional_time(0.);
+
+        // All the blocks are finalized. Keep the last one only, the next move will not be planned together with it,
+        // but its presence is tested when calculating the entry speed of the next move.
+        if (end > 1)
+            _release_blocks(end - 1);
+    }
+
+    void GCodeTimeEstimator::_finalize_planned_blocks()
+    {
+        PROFILE_FUNC();
+        // The entry speed of a block with nominal length is set to its maximum entry speed by the reverse pass
+        // independently of the blocks following it, and the forward pass does not propagate from it to the next block.
+        // Therefore the blocks preceding the last nominal length block of the window are planned the same way
+        // as if the planner passes were run over the whole sequence of blocks up to the next st_synchronize.
+        int begin = _last_st_synchronized_block_id + 1;
+        int end = (int)_blocks.size();
+        // Only the blocks added since the last call are searched, the last block needs a following block to be planned.
+        for (int i = std::max(_nominal_length_scan_id, begin + 1); i < end - 1; ++ i)
+            if (_blocks[i].flags.nominal_length)
+                _last_nominal_length_block_id = i;
+        _nominal_length_scan_id = end - 1;
+
+        // The blocks before last_planned will be finalized.
+        int last_planned = _last_nominal_length_block_id;
+        int plan_end;
+        if (last_planned > begin) {
+            // The reverse pass needs the block following the nominal length block to set its entry speed.
+            plan_end = last_planned + 2;
+        } else if (end - begin > Planner_Window_Max_Size) {
+            // A long run of short segments, for example a spiral vase, may have no block reaching its nominal speed.
+            // Finalize the blocks up to the last Planner_Window_Size blocks, which are used for planning them.
+            // The firmware plans over a much shorter buffer of moves, therefore the estimate does not suffer.
+            last_planned = end - Planner_Window_Size;
+            plan_end = end;
+        } else
+            return;
+
+        _forward_pass(begin, plan_end);
+        _reverse_pass(begin, plan_end);
+        // The trapezoid of the last planned block itself depends on the entry speed of the next block, which is not final yet.
+        _recalculate_trapezoids(begin, last_planned + 1);
+        _accumulate_time(begin, last_planned);
+
+        // The last planned block becomes the first block of the planner window.
+        _release_blocks(last_planned);
+    }
+
+    void GCodeTimeEstimator::_accumulate_time(int begin, int end)
+    {
+        PROFILE_FUNC();
+        for (int i = begin; i < end; ++i)
         {
             Block& block = _blocks[i];
 
@@ -741,15 +856,39 @@ namespace Slic3r {
 #endif // ENABLE_MOVE_STATS
         }
 
-        _last_st_synchronized_block_id = (int)_blocks.size() - 1;
-        // The additional time has been consumed (added to the total time), reset it to zero.
-        set_additional_time(0.);
+        // Record the time checkpoints of the extruding moves, at most one per _time_checkpoints_interval.
+        for (const G1LineIdToBlockId &line_block : _g1_line_ids)
+        {
+            if ((int)line_block.second >= end)
+                break;
+            if ((int)line_block.second < begin)
+                continue;
+            float elapsed_time = _blocks[line_block.second].elapsed_time;
+            if (_time_checkpoints.empty() || (elapsed_time - _time_checkpoints.back().elapsed_time > _time_checkpoints_interval))
+                _time_checkpoints.emplace_back(line_block.first, elapsed_time);
+        }
+    }
+
+    void GCodeTimeEstimator::_release_blocks(int num_blocks)
+    {
+        assert(num_blocks >= 0 && num_blocks <= (int)_blocks.size());
+        _blocks.erase(_blocks.begin(), _blocks.begin() + num_blocks);
+        _last_st_synchronized_block_id = std::max(-1, _last_st_synchronized_block_id - num_blocks);
+        _last_nominal_length_block_id = std::max(-1, _last_nominal_length_block_id - num_blocks);
+        _nominal_length_scan_id = std::max(0, _nominal_length_scan_id - num_blocks);
+        // Drop the line ids of the released blocks, shift the others.
+        G1LineIdToBlockIdMap::iterator it_end = _g1_line_ids.begin();
+        while (it_end != _g1_line_ids.end() && (int)it_end->second < num_blocks)
+            ++ it_end;
+        _g1_line_ids.erase(_g1_line_ids.begin(), it_end);
+        for (G1LineIdToBlockId &line_block : _g1_line_ids)
+            line_block.second -= (unsigned int)num_blocks;
     }
 
     void GCodeTimeEstimator::_process_gcode_line(GCodeReader&, const GCodeReader::GCodeLine& line)
     {
         PROFILE_FUNC();
-        std::string cmd = line.cmd();
+        const boost::string_view &cmd = line.cmd();
         if (cmd.length() > 1)
         {
             switch (::toupper(cmd[0]))
@@ -1082,7 +1221,13 @@ namespace Slic3r {
 
         // adds block to blocks list
         _blocks.emplace_back(block);
-        _g1_line_ids.emplace_back(G1LineIdToBlockIdMap::value_type(get_g1_line_id(), (unsigned int)_blocks.size() - 1));
+        // only the extruding moves are used by the export of remaining times
+        if (line.has_e())
+            _g1_line_ids.emplace_back(G1LineIdToBlockIdMap::value_type(get_g1_line_id(), (unsigned int)_blocks.size() - 1));
+
+        // periodically finalize the oldest blocks to keep the planner window bounded
+        if ((_blocks.size() - (_last_st_synchronized_block_id + 1)) % Planner_Window_Size == 0)
+            _finalize_planned_blocks();
     }
 
     void GCodeTimeEstimator::_processG4(const GCodeReader::GCodeLine& line)
@@ -1341,10 +1486,10 @@ namespace Slic3r {
 
     void GCodeTimeEstimator::_processT(const GCodeReader::GCodeLine& line)
     {
-        std::string cmd = line.cmd();
+        const boost::string_view &cmd = line.cmd();
         if (cmd.length() > 1)
         {
-            unsigned int id = (unsigned int)::strtol(cmd.substr(1).c_str(), nullptr, 10);
+            unsigned int id = (unsigned int)::strtol(cmd.data() + 1, nullptr, 10);
             if (get_extruder_id() != id)
             {
                 // Specific to the MK3 MMU2: The initial extruder ID is set to -1 indicating
@@ -1363,24 +1508,24 @@ namespace Slic3r {
         _calculate_time();
     }
 
-    void GCodeTimeEstimator::_forward_pass()
+    void GCodeTimeEstimator::_forward_pass(int begin, int end)
     {
         PROFILE_FUNC();
-        if (_blocks.size() > 1)
+        if (end - begin > 1)
         {
-            for (int i = _last_st_synchronized_block_id + 1; i < (int)_blocks.size() - 1; ++i)
+            for (int i = begin; i < end - 1; ++i)
             {
                 _planner_forward_pass_kernel(_blocks[i], _blocks[i + 1]);
             }
         }
     }
 
-    void GCodeTimeEstimator::_reverse_pass()
+    void GCodeTimeEstimator::_reverse_pass(int begin, int end)
     {
         PROFILE_FUNC();
-        if (_blocks.size() > 1)
+        if (end - begin > 1)
         {
-            for (int i = (int)_blocks.size() - 1; i >= _last_st_synchronized_block_id + 2; --i)
+            for (int i = end - 1; i >= begin + 1; --i)
             {
                 _planner_reverse_pass_kernel(_blocks[i - 1], _blocks[i]);
             }
@@ -1428,13 +1573,14 @@ namespace Slic3r {
         }
     }
 
-    void GCodeTimeEstimator::_recalculate_trapezoids()
+    // Recalculates the trapezoids of the blocks in <begin, end - 1), and of the last block if end is the end of the planner window.
+    void GCodeTimeEstimator::_recalculate_trapezoids(int begin, int end)
     {
         PROFILE_FUNC();
         Block* curr = nullptr;
         Block* next = nullptr;
 
-        for (int i = _last_st_synchronized_block_id + 1; i < (int)_blocks.size(); ++i)
+        for (int i = begin; i < end; ++i)
         {
             Block& b = _blocks[i];
 
@@ -1457,7 +1603,7 @@ namespace Slic3r {
         }
 
         // Last/newest block in buffer. Always recalculated.
-        if (next != nullptr)
+        if (next != nullptr && end == (int)_blocks.size())
         {
             Block block = *next;
             block.feedrate.exit = next->safe_feedrate;
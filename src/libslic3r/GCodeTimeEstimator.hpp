@@ -212,17 +212,44 @@ namespace Slic3r {
         typedef std::pair<unsigned int, unsigned int> G1LineIdToBlockId;
         typedef std::vector<G1LineIdToBlockId> G1LineIdToBlockIdMap;
 
+        // Elapsed time at the end of an extruding G1 line, used to export the remaining times.
+        struct TimeCheckpoint
+        {
+            unsigned int g1_line_id;
+            float elapsed_time; // s
+
+            TimeCheckpoint(unsigned int g1_line_id, float elapsed_time) : g1_line_id(g1_line_id), elapsed_time(elapsed_time) {}
+        };
+
+        typedef std::vector<TimeCheckpoint> TimeCheckpointsList;
+
+        // Number of blocks added to the planner window between two attempts to finalize its oldest blocks.
+        static const int Planner_Window_Size = 64;
+        // Maximum number of blocks in the planner window. If no block with a nominal length is found,
+        // the oldest blocks are finalized anyway, planned with the following Planner_Window_Size blocks.
+        static const int Planner_Window_Max_Size = 64 * Planner_Window_Size;
+
     private:
         EMode _mode;
         GCodeReader _parser;
         State _state;
         Feedrates _curr;
         Feedrates _prev;
+        // Planner window: the blocks not yet finalized. Once the time of a block is known, the block is released,
+        // so that the memory consumption does not grow with the size of the G-code.
         BlocksList _blocks;
-        // Map between g1 line id and blocks id, used to speed up export of remaining times
+        // Map between g1 line id and blocks id of the extruding moves inside the planner window
         G1LineIdToBlockIdMap _g1_line_ids;
+        // Elapsed times of the finalized extruding moves, used by the export of remaining times
+        TimeCheckpointsList _time_checkpoints;
+        // Minimum time between two consecutive time checkpoints
+        float _time_checkpoints_interval; // s
         // Index of the last block already st_synchronized
         int _last_st_synchronized_block_id;
+        // Index of the last block with a nominal length found in the planner window, -1 if none.
+        int _last_nominal_length_block_id;
+        // The blocks of the planner window before this index were already searched for the nominal length.
+        int _nominal_length_scan_id;
         float _time; // s
 
 #if ENABLE_MOVE_STATS
@@ -238,11 +265,13 @@ namespace Slic3r {
         void add_gcode_block(const char *ptr);
         void add_gcode_block(const std::string &str) { this->add_gcode_block(str.c_str()); }
 
+        // Adds the given gcode block to multiple time estimators (for example for the normal and the silent mode,
+        // or for any other set of machine limits). Each line is parsed just once and then processed by all the estimators.
+        static void add_gcode_block(const char *ptr, GCodeTimeEstimator * const *estimators, size_t num_estimators);
+
         // Calculates the time estimate from the gcode lines added using add_gcode_line() or add_gcode_block()
-        // start_from_beginning:
-        // if set to true all blocks will be used to calculate the time estimate,
-        // if set to false only the blocks not yet processed will be used and the calculated time will be added to the current calculated time
-        void calculate_time(bool start_from_beginning);
+        // Only the blocks not yet processed are used, the calculated time is added to the current calculated time.
+        void calculate_time();
 
         // Calculates the time estimate from the given gcode in string format
         void calculate_time_from_text(const std::string& gcode);
@@ -258,8 +287,13 @@ namespace Slic3r {
         // and saving the result back in the same file
         // This time estimator should have been already used to calculate the time estimate for the gcode
         // contained in the given file before to call this method
+        // The interval should not be shorter than the one passed to set_remaining_times_interval().
         bool post_process_remaining_times(const std::string& filename, float interval_sec);
 
+        // Same as above for multiple time estimators (typically for the normal and the silent mode),
+        // the file is read and written just once for all of them.
+        static bool post_process_remaining_times(const std::string& filename, float interval_sec, const std::vector<const GCodeTimeEstimator*>& estimators);
+
         // Set current position on the given axis with the given value
         void set_axis_position(EAxis axis, float position);
 
@@ -319,6 +353,9 @@ namespace Slic3r {
 
         void set_extruder_id(unsigned int id);
         unsigned int get_extruder_id() const;
+        // Only one time checkpoint per the given interval is kept for the export of the remaining times.
+        void set_remaining_times_interval(float interval_sec);
+
         void reset_extruder_id();
 
         void add_additional_time(float timeSec);
@@ -331,6 +368,7 @@ namespace Slic3r {
         void reset();
 
         // Returns the estimated time, in seconds
+        // While the G-code is being added, the time of the blocks already finalized by the planner is returned.
         float get_time() const;
 
         // Returns the estimated time, in format DDd HHh MMm SSs
@@ -416,13 +454,22 @@ namespace Slic3r {
         // Simulates firmware st_synchronize() call
         void _simulate_st_synchronize();
 
-        void _forward_pass();
-        void _reverse_pass();
+        // Finalizes the oldest blocks of the planner window, which will not be modified by the blocks still to be added.
+        void _finalize_planned_blocks();
+
+        // Accumulates the time of the blocks in the given range and records the time checkpoints.
+        void _accumulate_time(int begin, int end);
+
+        // Removes the given number of finalized blocks from the planner window.
+        void _release_blocks(int num_blocks);
+
+        void _forward_pass(int begin, int end);
+        void _reverse_pass(int begin, int end);
 
         void _planner_forward_pass_kernel(Block& prev, Block& curr);
         void _planner_reverse_pass_kernel(Block& curr, Block& next);
 
-        void _recalculate_trapezoids();
+        void _recalculate_trapezoids(int begin, int end);
 
         // Returns the given time is seconds in format DDd HHh MMm SSs
         static std::string _get_time_dhms(float time_in_secs);
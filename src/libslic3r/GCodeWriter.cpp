@@ -1,5 +1,8 @@
 #include "GCodeWriter.hpp"
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -14,6 +17,94 @@
 
 namespace Slic3r {
 
+// Formatter of the G1 lines, appending directly to the output string.
+// The numbers are printed the same way as std::fixed << std::setprecision(digits) (or printf("%.*f")) would print them,
+// but without the streams, the locale and the temporary strings, as formatting the moves is the hot spot of the G-code export.
+class GCodeG1Formatter
+{
+public:
+    GCodeG1Formatter(std::string &out) : m_out(out) { m_out += "G1"; }
+
+    void emit_axis(const char axis, double value, int digits)
+    {
+        m_out += ' ';
+        m_out += axis;
+        this->emit_fixed(value, digits);
+    }
+
+    void emit_axis(const std::string &axis, double value, int digits)
+    {
+        m_out += ' ';
+        m_out += axis;
+        this->emit_fixed(value, digits);
+    }
+
+    void emit_xy(const Vec2d &point)
+    {
+        this->emit_axis('X', point(0), XYZF_DIGITS);
+        this->emit_axis('Y', point(1), XYZF_DIGITS);
+    }
+
+    void emit_xyz(const Vec3d &point)
+    {
+        this->emit_xy(to_2d(point));
+        this->emit_axis('Z', point(2), XYZF_DIGITS);
+    }
+
+    void emit_comment(bool allow_comments, const std::string &comment)
+    {
+        if (allow_comments && ! comment.empty()) {
+            m_out += " ; ";
+            m_out += comment;
+        }
+    }
+
+    void finish() { m_out += '\n'; }
+
+    static const int XYZF_DIGITS = 3;
+    static const int E_DIGITS    = 5;
+
+private:
+    void emit_fixed(double value, int digits)
+    {
+        static const double   pow10d[] = { 1., 10., 100., 1000., 10000., 100000., 1000000. };
+        static const uint64_t pow10i[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+        assert(digits >= 0 && digits <= 6);
+        double scaled = std::abs(value) * pow10d[digits];
+        double integral = std::floor(scaled);
+        double fraction = scaled - integral;
+        // The product is rounded to at most half an ulp. If the fractional part is too close to the half,
+        // the rounding direction of the exact product is not known, let printf decide. NaN and large numbers go the same way.
+        if (! (scaled < 1e15) || std::abs(fraction - 0.5) <= scaled * 1e-15) {
+            char buf[512];
+            int len = ::snprintf(buf, sizeof(buf), "%.*f", digits, value);
+            m_out.append(buf, std::min<size_t>(std::max(len, 0), sizeof(buf) - 1));
+            return;
+        }
+        uint64_t num = uint64_t(integral) + (fraction > 0.5 ? 1 : 0);
+        // Digits in reverse order, the decimal part padded with zeros.
+        char  buf[32];
+        char *ptr = buf;
+        uint64_t int_part  = num / pow10i[digits];
+        uint64_t frac_part = num % pow10i[digits];
+        for (int i = 0; i < digits; ++ i, frac_part /= 10)
+            *ptr ++ = char('0' + frac_part % 10);
+        if (digits > 0)
+            *ptr ++ = '.';
+        do {
+            *ptr ++ = char('0' + int_part % 10);
+            int_part /= 10;
+        } while (int_part > 0);
+        // printf prints the sign of a negative number even if it is rounded to zero.
+        if (std::signbit(value))
+            *ptr ++ = '-';
+        std::reverse(buf, ptr);
+        m_out.append(buf, ptr);
+    }
+
+    std::string &m_out;
+};
+
 void GCodeWriter::apply_print_config(const PrintConfig &print_config)
 {
     this->config.apply(print_config, true);
@@ -276,18 +367,16 @@ std::string GCodeWriter::set_speed(double F, const std::string &comment, const s
     return gcode.str();
 }
 
-std::string GCodeWriter::travel_to_xy(const Vec2d &point, const std::string &comment)
+void GCodeWriter::travel_to_xy(std::string &out, const Vec2d &point, const std::string &comment)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<   " F" << XYZF_NUM(this->config.travel_speed.value * 60.0);
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    GCodeG1Formatter gcode(out);
+    gcode.emit_xy(point);
+    gcode.emit_axis('F', this->config.travel_speed.value * 60.0, GCodeG1Formatter::XYZF_DIGITS);
+    gcode.emit_comment(this->config.gcode_comments, comment);
+    gcode.finish();
 }
 
 std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const std::string &comment)
@@ -307,14 +396,13 @@ std::string GCodeWriter::travel_to_xyz(const Vec3d &point, const std::string &co
     m_lifted = 0;
     m_pos = point;
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<   " Z" << XYZF_NUM(point(2))
-          <<   " F" << XYZF_NUM(this->config.travel_speed.value * 60.0);
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    std::string out;
+    GCodeG1Formatter gcode(out);
+    gcode.emit_xyz(point);
+    gcode.emit_axis('F', this->config.travel_speed.value * 60.0, GCodeG1Formatter::XYZF_DIGITS);
+    gcode.emit_comment(this->config.gcode_comments, comment);
+    gcode.finish();
+    return out;
 }
 
 std::string GCodeWriter::travel_to_z(double z, const std::string &comment)
@@ -338,12 +426,13 @@ std::string GCodeWriter::_travel_to_z(double z, const std::string &comment)
 {
     m_pos(2) = z;
     
-    std::ostringstream gcode;
-    gcode << "G1 Z" << XYZF_NUM(z)
-          <<   " F" << XYZF_NUM(this->config.travel_speed.value * 60.0);
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    std::string out;
+    GCodeG1Formatter gcode(out);
+    gcode.emit_axis('Z', z, GCodeG1Formatter::XYZF_DIGITS);
+    gcode.emit_axis('F', this->config.travel_speed.value * 60.0, GCodeG1Formatter::XYZF_DIGITS);
+    gcode.emit_comment(this->config.gcode_comments, comment);
+    gcode.finish();
+    return out;
 }
 
 bool GCodeWriter::will_move_z(double z) const
@@ -358,19 +447,17 @@ bool GCodeWriter::will_move_z(double z) const
     return true;
 }
 
-std::string GCodeWriter::extrude_to_xy(const Vec2d &point, double dE, const std::string &comment)
+void GCodeWriter::extrude_to_xy(std::string &out, const Vec2d &point, double dE, const std::string &comment)
 {
     m_pos(0) = point(0);
     m_pos(1) = point(1);
     m_extruder->extrude(dE);
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<    " " << m_extrusion_axis << E_NUM(m_extruder->E());
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    GCodeG1Formatter gcode(out);
+    gcode.emit_xy(point);
+    gcode.emit_axis(m_extrusion_axis, m_extruder->E(), GCodeG1Formatter::E_DIGITS);
+    gcode.emit_comment(this->config.gcode_comments, comment);
+    gcode.finish();
 }
 
 std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std::string &comment)
@@ -379,14 +466,13 @@ std::string GCodeWriter::extrude_to_xyz(const Vec3d &point, double dE, const std
     m_lifted = 0;
     m_extruder->extrude(dE);
     
-    std::ostringstream gcode;
-    gcode << "G1 X" << XYZF_NUM(point(0))
-          <<   " Y" << XYZF_NUM(point(1))
-          <<   " Z" << XYZF_NUM(point(2))
-          <<    " " << m_extrusion_axis << E_NUM(m_extruder->E());
-    COMMENT(comment);
-    gcode << "\n";
-    return gcode.str();
+    std::string out;
+    GCodeG1Formatter gcode(out);
+    gcode.emit_xyz(point);
+    gcode.emit_axis(m_extrusion_axis, m_extruder->E(), GCodeG1Formatter::E_DIGITS);
+    gcode.emit_comment(this->config.gcode_comments, comment);
+    gcode.finish();
+    return out;
 }
 
 std::string GCodeWriter::retract(bool before_wipe)
@@ -4,6 +4,7 @@
 #include "ExPolygon.hpp"
 #include "Line.hpp"
 #include "PolylineCollection.hpp"
+#include "ShortestPath.hpp"
 #include "clipper.hpp"
 #include <algorithm>
 #include <cassert>
@@ -314,20 +315,13 @@ convex_hull(const Polygons &polygons)
 void
 chained_path(const Points &points, std::vector<Points::size_type> &retval, Point start_near)
 {
-    PointConstPtrs my_points;
-    std::map<const Point*,Points::size_type> indices;
-    my_points.reserve(points.size());
-    for (Points::const_iterator it = points.begin(); it != points.end(); ++it) {
-        my_points.push_back(&*it);
-        indices[&*it] = it - points.begin();
-    }
-    
+    ClosestEndPointIndex index(points, 1, ClosestEndPointIndex::tbLastUnlessCoincident);
     retval.reserve(points.size());
-    while (!my_points.empty()) {
-        Points::size_type idx = start_near.nearest_point_index(my_points);
-        start_near = *my_points[idx];
-        retval.push_back(indices[ my_points[idx] ]);
-        my_points.erase(my_points.begin() + idx);
+    while (index.num_items_left() > 0) {
+        Points::size_type idx = index.closest(start_near);
+        start_near = points[idx];
+        retval.push_back(idx);
+        index.remove_item(idx);
     }
 }
 
@@ -6,6 +6,7 @@
 #include "SurfaceCollection.hpp"
 #include "ExtrusionEntityCollection.hpp"
 #include "ExPolygonCollection.hpp"
+#include "PackedExPolygons.hpp"
 #include "PolylineCollection.hpp"
 
 
@@ -33,8 +34,8 @@ public:
     ExtrusionEntityCollection   thin_fills;
 
     // Unspecified fill polygons, used for overhang detection ("ensure vertical wall thickness feature")
-    // and for re-starting of infills.
-    ExPolygons                  fill_expolygons;
+    // and for re-starting of infills. Only read as a whole, therefore stored packed.
+    PackedExPolygons            fill_expolygons;
     // collection of surfaces for infill generation
     SurfaceCollection           fill_surfaces;
 
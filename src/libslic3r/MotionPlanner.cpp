@@ -3,6 +3,7 @@
 #include "MutablePriorityQueue.hpp"
 #include "Utils.hpp"
 
+#include <algorithm>
 #include <limits> // for numeric_limits
 #include <assert.h>
 
@@ -121,11 +122,13 @@ Polyline MotionPlanner::shortest_path(const Point &from, const Point &to)
     polyline.points.emplace_back(to);
     
     {
-        // grow our environment slightly in order for simplify_by_visibility()
-        // to work best by considering moves on boundaries valid as well
-        ExPolygonCollection grown_env(offset_ex(env.m_env.expolygons, float(+SCALED_EPSILON)));
-        
         if (island_idx == -1) {
+            // grow our environment slightly in order for simplify_by_visibility()
+            // to work best by considering moves on boundaries valid as well
+            // The offset is expensive, it is calculated once for all the travel moves over the open space.
+            if (m_outer_env_grown.expolygons.empty())
+                m_outer_env_grown = ExPolygonCollection(offset_ex(env.m_env.expolygons, float(+SCALED_EPSILON)));
+            const ExPolygonCollection &grown_env = m_outer_env_grown;
             /*  If 'from' or 'to' are not inside our env, they were connected using the 
                 nearest_env_point() search which maybe produce ugly paths since it does not
                 include the endpoint in the Dijkstra search; the simplify_by_visibility() 
@@ -192,12 +195,31 @@ const MotionPlannerGraph& MotionPlanner::init_graph(int island_idx)
         
         typedef voronoi_diagram<double> VD;
         VD vd;
-        // Mapping between Voronoi vertices and graph nodes.
-        std::map<const VD::vertex_type*, size_t> vd_vertices;
         // get boundaries as lines
         const MotionPlannerEnv &env = this->get_env(island_idx);
         Lines lines = env.m_env.lines();
         boost::polygon::construct_voronoi(lines.begin(), lines.end(), &vd);
+        // The state of a Voronoi vertex is stored into its color: Whether it has been tested for being inside the island,
+        // and the index of its graph node. The island containment test is expensive, each vertex is only tested once.
+        enum VertexColor : VD::vertex_type::color_type {
+            vcUnknown = 0,
+            vcOutside,
+            vcInside,
+            // vcNode + index of the graph node.
+            vcNode,
+        };
+        auto vertex_inside = [&env](const VD::vertex_type *v, const Point &p) {
+            if (v->color() == vcUnknown)
+                //FIXME This test has a terrible O(n^2) time complexity.
+                v->color(env.island_contains_b(p) ? vcInside : vcOutside);
+            return v->color() != vcOutside;
+        };
+        // Find v in the graph, allocate a new node if v does not exist in the graph yet.
+        auto vertex_node = [graph](const VD::vertex_type *v, const Point &p) -> size_t {
+            if (v->color() == vcInside)
+                v->color(vcNode + graph->add_node(p));
+            return size_t(v->color() - vcNode);
+        };
         // traverse the Voronoi diagram and generate graph nodes and edges
         for (const VD::edge_type &edge : vd.edges()) {
             if (edge.is_infinite())
@@ -207,26 +229,14 @@ const MotionPlannerGraph& MotionPlanner::init_graph(int island_idx)
             Point p0(v0->x(), v0->y());
             Point p1(v1->x(), v1->y());
             // Insert only Voronoi edges fully contained in the island.
-            //FIXME This test has a terrible O(n^2) time complexity.
-            if (env.island_contains_b(p0) && env.island_contains_b(p1)) {
-                // Find v0 in the graph, allocate a new node if v0 does not exist in the graph yet.
-                auto i_v0 = vd_vertices.find(v0);
-                size_t v0_idx;
-                if (i_v0 == vd_vertices.end())
-                    vd_vertices[v0] = v0_idx = graph->add_node(p0);
-                else
-                    v0_idx = i_v0->second;
-                // Find v1 in the graph, allocate a new node if v0 does not exist in the graph yet.
-                auto i_v1 = vd_vertices.find(v1);
-                size_t v1_idx;
-                if (i_v1 == vd_vertices.end())
-                    vd_vertices[v1] = v1_idx = graph->add_node(p1);
-                else
-                    v1_idx = i_v1->second;
+            if (vertex_inside(v0, p0) && vertex_inside(v1, p1)) {
+                size_t v0_idx = vertex_node(v0, p0);
+                size_t v1_idx = vertex_node(v1, p1);
                 // Euclidean distance is used as weight for the graph edge
                 graph->add_edge(v0_idx, v1_idx, (p1 - p0).cast<double>().norm());
             }
         }
+        graph->finalize();
     }
 
     return *graph;
@@ -304,7 +314,45 @@ void MotionPlannerGraph::add_edge(size_t from, size_t to, double weight)
     m_adjacency_list[from].emplace_back(Neighbor(node_t(to), weight));
 }
 
-// Dijkstra's shortest path in a weighted graph from node_start to node_end.
+void MotionPlannerGraph::finalize()
+{
+    m_nodes_sorted_by_x.clear();
+    m_nodes_sorted_by_x.reserve(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++ i)
+        m_nodes_sorted_by_x.emplace_back(node_t(i));
+    std::sort(m_nodes_sorted_by_x.begin(), m_nodes_sorted_by_x.end(), 
+        [this](const node_t i1, const node_t i2) { return m_nodes[i1](0) < m_nodes[i2](0); });
+}
+
+size_t MotionPlannerGraph::find_closest_node(const Point &point) const
+{
+    assert(m_nodes_sorted_by_x.size() == m_nodes.size());
+    // Sweep the nodes sorted by x to both sides of point, until the x distance alone is bigger than the closest distance found.
+    // Out of the nodes at the same distance, the same node is returned as by point.nearest_point_index(m_nodes):
+    // The first node if coincident with point, otherwise the last node.
+    node_t idx_min  = -1;
+    double dist_min = std::numeric_limits<double>::infinity();
+    auto   visit    = [this, &point, &idx_min, &dist_min](const node_t idx) {
+        const Point &p  = m_nodes[idx];
+        double       dx = sqr<double>(point(0) - p(0));
+        if (dx > dist_min)
+            // Stop sweeping in this direction.
+            return false;
+        double d = dx + sqr<double>(point(1) - p(1));
+        if (d < dist_min || (d == dist_min && (d == 0. ? (idx < idx_min) : (idx > idx_min)))) {
+            idx_min  = idx;
+            dist_min = d;
+        }
+        return true;
+    };
+    auto it_right = std::lower_bound(m_nodes_sorted_by_x.begin(), m_nodes_sorted_by_x.end(), point(0), 
+        [this](const node_t idx, const coord_t x) { return m_nodes[idx](0) < x; });
+    for (auto it = it_right; it != m_nodes_sorted_by_x.end() && visit(*it); ++ it) ;
+    for (auto it = it_right; it != m_nodes_sorted_by_x.begin() && visit(*(-- it)); ) ;
+    return size_t(idx_min);
+}
+
+// A* shortest path in a weighted graph from node_start to node_end.
 // The returned path contains the end points.
 // If no path exists from node_start to node_end, a straight segment is returned.
 Polyline MotionPlannerGraph::shortest_path(size_t node_start, size_t node_end) const
@@ -313,45 +361,62 @@ Polyline MotionPlannerGraph::shortest_path(size_t node_start, size_t node_end) c
     if (this->empty())
         return Polyline();
 
-    // Dijkstra algorithm, previous node of the current node 'u' in the shortest path towards node_start.
-    std::vector<node_t>   previous(m_adjacency_list.size(), -1);
-    std::vector<weight_t> distance(m_adjacency_list.size(), std::numeric_limits<weight_t>::infinity());
-    std::vector<size_t>   map_node_to_queue_id(m_adjacency_list.size(), size_t(-1));
+    // The straight distance to node_end never overestimates the remaining path length, as the edge weights are
+    // the Euclidean distances of their end points. Such an estimate is consistent, therefore the first visit
+    // of a node is over its shortest path from node_start and only the nodes towards node_end are explored.
+    const Point &point_end = m_nodes[node_end];
+    auto estimate_remaining = [this, &point_end](const node_t node) { return (point_end - m_nodes[node]).cast<double>().norm(); };
+
+    // Previous node of the current node 'u' in the shortest path towards node_start.
+    std::vector<node_t>   previous(m_nodes.size(), -1);
+    std::vector<weight_t> distance(m_nodes.size(), std::numeric_limits<weight_t>::infinity());
+    // Distance from node_start plus the estimated distance to node_end, the key of the priority queue.
+    std::vector<weight_t> estimate(m_nodes.size(), std::numeric_limits<weight_t>::infinity());
+    const size_t          not_queued = size_t(-1);
+    const size_t          visited    = size_t(-2);
+    std::vector<size_t>   map_node_to_queue_id(m_nodes.size(), not_queued);
     distance[node_start] = 0.;
+    estimate[node_start] = estimate_remaining(node_t(node_start));
 
     auto queue = make_mutable_priority_queue<node_t>(
         [&map_node_to_queue_id](const node_t node, size_t idx) { map_node_to_queue_id[node] = idx; },
-        [&distance](const node_t node1, const node_t node2) { return distance[node1] < distance[node2]; });
-    queue.reserve(m_adjacency_list.size());
-    for (size_t i = 0; i < m_adjacency_list.size(); ++ i)
-        queue.push(node_t(i));
+        [&estimate](const node_t node1, const node_t node2) { return estimate[node1] < estimate[node2]; });
+    queue.push(node_t(node_start));
 
     while (! queue.empty()) {
-        // Get the next node with the lowest distance to node_start.
+        // Get the next node with the lowest estimated length of a path from node_start to node_end.
         node_t u = node_t(queue.top());
         queue.pop();
-        map_node_to_queue_id[u] = size_t(-1);
+        map_node_to_queue_id[u] = visited;
         // Stop searching if we reached our destination.
         if (u == node_end)
             break;
+        if (size_t(u) >= m_adjacency_list.size())
+            // No edge starts at node u.
+            continue;
         // Visit each edge starting at node u.
-        for (const Neighbor& neighbor : m_adjacency_list[u])
-            if (map_node_to_queue_id[neighbor.target] != size_t(-1)) {
-                weight_t alt = distance[u] + neighbor.weight;
-                // If total distance through u is shorter than the previous
-                // distance (if any) between node_start and neighbor.target, replace it.
-                if (alt < distance[neighbor.target]) {
-                    distance[neighbor.target] = alt;
-                    previous[neighbor.target] = u;
-                    queue.update(map_node_to_queue_id[neighbor.target]);
-                }
+        for (const Neighbor& neighbor : m_adjacency_list[u]) {
+            size_t queue_id = map_node_to_queue_id[neighbor.target];
+            if (queue_id == visited)
+                continue;
+            weight_t alt = distance[u] + neighbor.weight;
+            // If total distance through u is shorter than the previous
+            // distance (if any) between node_start and neighbor.target, replace it.
+            if (alt < distance[neighbor.target]) {
+                distance[neighbor.target] = alt;
+                estimate[neighbor.target] = alt + estimate_remaining(neighbor.target);
+                previous[neighbor.target] = u;
+                if (queue_id == not_queued)
+                    queue.push(neighbor.target);
+                else
+                    queue.update(queue_id);
             }
+        }
     }
 
     // In case the end point was not reached, previous[node_end] contains -1
     // and a straight line from node_start to node_end is returned.
     Polyline polyline;
-    polyline.points.reserve(m_adjacency_list.size());
     for (node_t vertex = node_t(node_end); vertex != -1; vertex = previous[vertex])
         polyline.points.emplace_back(m_nodes[vertex]);
     polyline.points.emplace_back(m_nodes[node_start]);
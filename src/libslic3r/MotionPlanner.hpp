@@ -38,14 +38,17 @@ private:
     ExPolygonCollection m_env;
 };
 
-// A 2D directed graph for searching a shortest path using the famous Dijkstra algorithm.
+// A 2D directed graph for searching a shortest path using the A* algorithm.
+// The edge weights are expected to be the Euclidean distances of their end points.
 class MotionPlannerGraph
 {    
 public:
     // Add a directed edge into the graph.
     size_t   add_node(const Point &p) { m_nodes.emplace_back(p); return m_nodes.size() - 1; }
     void     add_edge(size_t from, size_t to, double weight);
-    size_t   find_closest_node(const Point &point) const { return point.nearest_point_index(m_nodes); }
+    // To be called after all the nodes were added to index the nodes for find_closest_node().
+    void     finalize();
+    size_t   find_closest_node(const Point &point) const;
 
     bool     empty() const { return m_adjacency_list.empty(); }
     Polyline shortest_path(size_t from, size_t to) const;
@@ -62,6 +65,8 @@ private:
     };
     Points                              m_nodes;
     std::vector<std::vector<Neighbor>>  m_adjacency_list;
+    // Indices of m_nodes sorted by their x coordinate, for find_closest_node().
+    std::vector<node_t>                 m_nodes_sorted_by_x;
 };
 
 class MotionPlanner
@@ -72,15 +77,19 @@ public:
 
     Polyline    shortest_path(const Point &from, const Point &to);
     size_t      islands_count() const { return m_islands.size(); }
+    // The configuration space is created lazily by shortest_path(). Create it in advance, for example from a background thread.
+    // The graphs are still created by shortest_path() on demand, as they are expensive and most of them are never searched.
+    void        initialize();
 
 private:
     bool                                m_initialized;
     std::vector<MotionPlannerEnv>       m_islands;
     MotionPlannerEnv                    m_outer;
+    // m_outer.m_env grown by SCALED_EPSILON, created on demand by shortest_path().
+    ExPolygonCollection                 m_outer_env_grown;
     // 0th graph is the graph for m_outer. Other graphs are 1 indexed.
     std::vector<std::unique_ptr<MotionPlannerGraph>> m_graphs;
     
-    void                      initialize();
     const MotionPlannerGraph& init_graph(int island_idx);
     const MotionPlannerEnv&   get_env(int island_idx) const
         { return (island_idx == -1) ? m_outer : m_islands[island_idx]; }
@@ -0,0 +1,85 @@
+#include "PackedExPolygons.hpp"
+
+#include <cassert>
+#include <limits>
+
+namespace Slic3r {
+
+void PackedExPolygons::assign(const ExPolygons &src)
+{
+    this->clear();
+    if (src.empty())
+        return;
+
+    // Allocate the buffers to their final sizes, they are not going to grow.
+    size_t num_points   = 0;
+    size_t num_polygons = 0;
+    for (const ExPolygon &expoly : src) {
+        num_points   += expoly.contour.points.size();
+        num_polygons += expoly.holes.size() + 1;
+        for (const Polygon &hole : expoly.holes)
+            num_points += hole.points.size();
+    }
+    assert(num_points < size_t(std::numeric_limits<uint32_t>::max()));
+    m_points.reserve(num_points);
+    m_polygon_start.reserve(num_polygons + 1);
+    m_expolygon_start.reserve(src.size() + 1);
+
+    m_polygon_start.emplace_back(0);
+    m_expolygon_start.emplace_back(0);
+    auto append = [this](const Polygon &polygon) {
+        m_points.insert(m_points.end(), polygon.points.begin(), polygon.points.end());
+        m_polygon_start.emplace_back(uint32_t(m_points.size()));
+    };
+    for (const ExPolygon &expoly : src) {
+        append(expoly.contour);
+        for (const Polygon &hole : expoly.holes)
+            append(hole);
+        m_expolygon_start.emplace_back(uint32_t(m_polygon_start.size() - 1));
+    }
+}
+
+void PackedExPolygons::clear()
+{
+    // Release the memory, the buffers are sized exactly by assign().
+    Points().swap(m_points);
+    std::vector<uint32_t>().swap(m_polygon_start);
+    std::vector<uint32_t>().swap(m_expolygon_start);
+}
+
+ExPolygon PackedExPolygons::expolygon(size_t idx) const
+{
+    ExPolygon out;
+    out.contour = this->contour(idx).polygon();
+    size_t num_holes = this->num_holes(idx);
+    out.holes.reserve(num_holes);
+    for (size_t i = 0; i < num_holes; ++ i)
+        out.holes.emplace_back(this->hole(idx, i).polygon());
+    return out;
+}
+
+size_t PackedExPolygons::memory_used() const
+{
+    return m_points.capacity() * sizeof(Point) +
+        (m_polygon_start.capacity() + m_expolygon_start.capacity()) * sizeof(uint32_t);
+}
+
+ExPolygons to_expolygons(const PackedExPolygons &src)
+{
+    ExPolygons out;
+    out.reserve(src.size());
+    for (size_t i = 0; i < src.size(); ++ i)
+        out.emplace_back(src.expolygon(i));
+    return out;
+}
+
+Polygons to_polygons(const PackedExPolygons &src)
+{
+    Polygons out;
+    out.reserve(src.num_polygons());
+    for (size_t i = 0; i < src.num_polygons(); ++ i)
+        out.emplace_back(src.polygon(i).polygon());
+    return out;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,67 @@
+#ifndef slic3r_PackedExPolygons_hpp_
+#define slic3r_PackedExPolygons_hpp_
+
+#include "libslic3r.h"
+#include "ExPolygon.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Slic3r {
+
+// Read only ExPolygons in a compact form for the geometry kept with the layers until the print is finished.
+// ExPolygons allocate a vector of holes per ExPolygon and a vector of points per contour and hole. For a tall print
+// with perforated layers these small allocations add up to a considerable heap overhead and allocator time.
+// Here the points of all the contours and holes are stored in a single buffer, and the polygons and the ExPolygons
+// are delimited by two tables of offsets.
+class PackedExPolygons
+{
+public:
+    // Points of a contour or a hole, a view into the buffer of a PackedExPolygons.
+    struct PolygonView
+    {
+        const Point *begin;
+        const Point *end;
+
+        size_t  size() const { return end - begin; }
+        Polygon polygon() const { Polygon out; out.points.assign(begin, end); return out; }
+    };
+
+    PackedExPolygons() {}
+    explicit PackedExPolygons(const ExPolygons &src) { this->assign(src); }
+    PackedExPolygons& operator=(const ExPolygons &src) { this->assign(src); return *this; }
+
+    void        assign(const ExPolygons &src);
+    void        clear();
+    bool        empty() const { return m_expolygon_start.size() < 2; }
+    // Number of the ExPolygons.
+    size_t      size() const { return this->empty() ? 0 : m_expolygon_start.size() - 1; }
+    // Number of the contours and holes.
+    size_t      num_polygons() const { return this->empty() ? 0 : m_polygon_start.size() - 1; }
+
+    PolygonView contour(size_t idx) const { return this->polygon(m_expolygon_start[idx]); }
+    size_t      num_holes(size_t idx) const { return m_expolygon_start[idx + 1] - m_expolygon_start[idx] - 1; }
+    PolygonView hole(size_t idx, size_t hole_idx) const { return this->polygon(m_expolygon_start[idx] + 1 + hole_idx); }
+    // Contours and holes of all the ExPolygons, in the order of to_polygons(const ExPolygons&).
+    PolygonView polygon(size_t polygon_idx) const
+        { return PolygonView{ m_points.data() + m_polygon_start[polygon_idx], m_points.data() + m_polygon_start[polygon_idx + 1] }; }
+    ExPolygon   expolygon(size_t idx) const;
+
+    // Bytes allocated on the heap, not counting the overhead of the allocator.
+    size_t      memory_used() const;
+
+private:
+    // Points of all the contours and holes.
+    Points                  m_points;
+    // Points of the i-th polygon are m_points[m_polygon_start[i] .. m_polygon_start[i + 1]).
+    std::vector<uint32_t>   m_polygon_start;
+    // Polygons of the i-th ExPolygon are [m_expolygon_start[i], m_expolygon_start[i + 1]), the contour first, then the holes.
+    std::vector<uint32_t>   m_expolygon_start;
+};
+
+extern ExPolygons to_expolygons(const PackedExPolygons &src);
+extern Polygons   to_polygons(const PackedExPolygons &src);
+
+} // namespace Slic3r
+
+#endif /* slic3r_PackedExPolygons_hpp_ */
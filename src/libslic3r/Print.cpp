@@ -18,6 +18,9 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+#include <tbb/task_group.h>
+
 //! macro used to mark string used at localization, 
 //! return same string
 #define L(s) Slic3r::I18N::translate(s)
@@ -396,10 +399,11 @@ void Print::add_model_object(ModelObject* model_object, int idx)
             continue;
         // Get the config applied to this volume.
         PrintRegionConfig config = PrintObject::region_config_from_model_volume(m_default_region_config, *volume, 99999);
+        uint64_t          config_hash = config.hash();
         // Find an existing print region with the same config.
         size_t region_id = size_t(-1);
         for (size_t i = 0; i < m_regions.size(); ++ i)
-            if (config.equals(m_regions[i]->config())) {
+            if (m_regions[i]->config_hash() == config_hash && config.equals(m_regions[i]->config())) {
                 region_id = i;
                 break;
             }
@@ -1018,9 +1022,10 @@ Print::ApplyStatus Print::apply(const Model &model, const DynamicPrintConfig &co
                             goto print_object_end;
                     } else {
                         this_region_config = PrintObject::region_config_from_model_volume(m_default_region_config, volume, num_extruders);
+                        uint64_t this_region_config_hash = this_region_config.hash();
 						for (size_t i = 0; i < region_id; ++i) {
 							const PrintRegion &region_other = *m_regions[i];
-							if (region_other.m_refcnt != 0 && region_other.config().equals(this_region_config))
+							if (region_other.m_refcnt != 0 && region_other.config_hash() == this_region_config_hash && region_other.config().equals(this_region_config))
 								// Regions were merged. Reset this print_object.
 								goto print_object_end;
 						}
@@ -1069,13 +1074,14 @@ Print::ApplyStatus Print::apply(const Model &model, const DynamicPrintConfig &co
                 if (&print_object == &print_object0) {
                     // Get the config applied to this volume.
                     PrintRegionConfig config = PrintObject::region_config_from_model_volume(m_default_region_config, *volume, num_extruders);
+                    uint64_t          config_hash = config.hash();
                     // Find an existing print region with the same config.
 					int idx_empty_slot = -1;
 					for (int i = 0; i < (int)m_regions.size(); ++ i) {
 						if (m_regions[i]->m_refcnt == 0) {
                             if (idx_empty_slot == -1)
                                 idx_empty_slot = i;
-                        } else if (config.equals(m_regions[i]->config())) {
+                        } else if (m_regions[i]->config_hash() == config_hash && config.equals(m_regions[i]->config())) {
                             region_id = i;
                             break;
                         }
@@ -1474,29 +1480,70 @@ void Print::auto_assign_extruders(ModelObject* model_object) const
 void Print::process()
 {
     BOOST_LOG_TRIVIAL(info) << "Staring the slicing process." << log_memory_info();
-    for (PrintObject *obj : m_objects)
-        obj->make_perimeters();
-    this->set_status(70, "Infilling layers");
-    for (PrintObject *obj : m_objects)
-        obj->infill();
-    for (PrintObject *obj : m_objects)
-        obj->generate_support_material();
-    if (this->set_started(psSkirt)) {
-        m_skirt.clear();
-        if (this->has_skirt()) {
-            this->set_status(88, "Generating skirt");
-            this->_make_skirt();
-        }
-        this->set_done(psSkirt);
+    // Each object advances through its slicing, perimeters, infill and support steps independently of the other objects,
+    // therefore the serial tails of the steps of one object are overlapped by the work on the other objects.
+    // The steps of a single object are parallelized over its layers, the TBB scheduler balances the nested parallelism.
+    // A single object reports the status of its steps, multiple objects report the number of the objects processed.
+    BOOST_LOG_TRIVIAL(debug) << "Processing objects in parallel - start";
+    m_objects_concurrent = m_objects.size() > 1;
+    if (m_objects_concurrent)
+        this->set_status(10, "Processing objects");
+    tbb::mutex num_processed_mutex;
+    size_t     num_processed = 0;
+    try {
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(0, m_objects.size(), 1),
+            [this, &num_processed_mutex, &num_processed](const tbb::blocked_range<size_t>& range) {
+                for (size_t object_idx = range.begin(); object_idx < range.end(); ++ object_idx) {
+                    PrintObject *obj = m_objects[object_idx];
+                    obj->make_perimeters();
+                    obj->infill();
+                    obj->generate_support_material();
+                    if (m_objects_concurrent) {
+                        // Reported under the lock, so that the progress does not go backwards.
+                        tbb::mutex::scoped_lock lock(num_processed_mutex);
+                        ++ num_processed;
+                        this->set_status(10 + int(78 * num_processed / m_objects.size()),
+                            "Processed " + std::to_string(num_processed) + " of " + std::to_string(m_objects.size()) + " objects");
+                    }
+                }
+            }
+        );
+    } catch (...) {
+        // Canceled, the objects report the status of their steps again.
+        m_objects_concurrent = false;
+        throw;
     }
-	if (this->set_started(psBrim)) {
-        m_brim.clear();
-        if (m_config.brim_width > 0) {
-            this->set_status(88, "Generating brim");
-            this->_make_brim();
-        }
-       this->set_done(psBrim);
+    m_objects_concurrent = false;
+    this->throw_if_canceled();
+    BOOST_LOG_TRIVIAL(debug) << "Processing objects in parallel - end";
+    // Skirt and brim need the slices and support layers of all objects, they are independent of each other, run them concurrently.
+    {
+        tbb::task_group task_group;
+        task_group.run([this]() {
+            if (this->set_started(psSkirt)) {
+                m_skirt.clear();
+                if (this->has_skirt()) {
+                    this->set_status(88, "Generating skirt");
+                    this->_make_skirt();
+                }
+                this->set_done(psSkirt);
+            }
+        });
+        task_group.run([this]() {
+            if (this->set_started(psBrim)) {
+                m_brim.clear();
+                if (m_config.brim_width > 0) {
+                    this->set_status(88, "Generating brim");
+                    this->_make_brim();
+                }
+                this->set_done(psBrim);
+            }
+        });
+        // Rethrows an exception (for example the CanceledException) thrown by any of the tasks.
+        task_group.wait();
     }
+    // The wipe tower may insert new support layers into the first object, therefore it has to wait for the skirt and brim.
     if (this->set_started(psWipeTower)) {
         m_wipe_tower_data.clear();
         if (this->has_wipe_tower()) {
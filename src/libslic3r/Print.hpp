@@ -39,6 +39,8 @@ class PrintRegion
 public:
     const Print*                print() const { return m_print; }
     const PrintRegionConfig&    config() const { return m_config; }
+    // Hash of config(), to quickly reject the regions of a different config when searching for a region of the same config.
+    uint64_t                    config_hash() const { return m_config_hash; }
     Flow                        flow(FlowRole role, double layer_height, bool bridge, bool first_layer, double width, const PrintObject &object) const;
     // Average diameter of nozzles participating on extruding this region.
     coordf_t                    nozzle_dmr_avg(const PrintConfig &print_config) const;
@@ -52,10 +54,10 @@ public:
 // Methods modifying the PrintRegion's state:
 public:
     Print*                      print() { return m_print; }
-    void                        set_config(const PrintRegionConfig &config) { m_config = config; }
-    void                        set_config(PrintRegionConfig &&config) { m_config = std::move(config); }
+    void                        set_config(const PrintRegionConfig &config) { m_config = config; m_config_hash = m_config.hash(); }
+    void                        set_config(PrintRegionConfig &&config) { m_config = std::move(config); m_config_hash = m_config.hash(); }
     void                        config_apply_only(const ConfigBase &other, const t_config_option_keys &keys, bool ignore_nonexistent = false) 
-                                        { this->m_config.apply_only(other, keys, ignore_nonexistent); }
+                                        { this->m_config.apply_only(other, keys, ignore_nonexistent); m_config_hash = m_config.hash(); }
 
 protected:
     size_t             m_refcnt;
@@ -63,9 +65,10 @@ protected:
 private:
     Print             *m_print;
     PrintRegionConfig  m_config;
+    uint64_t           m_config_hash;
     
-    PrintRegion(Print* print) : m_refcnt(0), m_print(print) {}
-    PrintRegion(Print* print, const PrintRegionConfig &config) : m_refcnt(0), m_print(print), m_config(config) {}
+    PrintRegion(Print* print) : m_refcnt(0), m_print(print), m_config_hash(m_config.hash()) {}
+    PrintRegion(Print* print, const PrintRegionConfig &config) : m_refcnt(0), m_print(print), m_config(config), m_config_hash(m_config.hash()) {}
     ~PrintRegion() {}
 };
 
@@ -168,6 +171,9 @@ protected:
     static PrintRegionConfig region_config_from_model_volume(const PrintRegionConfig &default_region_config, const ModelVolume &volume, size_t num_extruders);
 
 private:
+    // Reports the status of a step of this object, unless Print::process() processes the objects concurrently.
+    void set_status(int percent, const std::string &message);
+
     void make_perimeters();
     void prepare_infill();
     void infill();
@@ -392,6 +398,10 @@ private:
     // Estimated print time, filament consumed.
     PrintStatistics                         m_print_statistics;
 
+    // Set by process() while the print objects are processed concurrently. The status updates of the steps
+    // of different objects would interleave out of order, therefore process() reports the progress of the objects instead.
+    bool                                    m_objects_concurrent = false;
+
     // To allow GCode to set the Print's GCodeExport step status.
     friend class GCode;
     // Allow PrintObject to access m_mutex and m_cancel_callback.
@@ -20,6 +20,8 @@
 #include "libslic3r.h"
 #include "Config.hpp"
 
+#include <typeinfo>
+
 // #define HAS_PRESSURE_EQUALIZER
 
 namespace Slic3r {
@@ -225,6 +227,9 @@ public:
 template<typename CONFIG>
 void normalize_and_apply_config(CONFIG &dst, const DynamicPrintConfig &src)
 {
+    if (src.empty())
+        // Most of the objects and volumes do not override any option, don't copy the empty config for nothing.
+        return;
     DynamicPrintConfig src_normalized(src);
     src_normalized.normalize();
     dst.apply(src_normalized, true);
@@ -289,6 +294,34 @@ protected:
         const std::vector<std::string>& keys()      const { return m_keys; }
         const T&                        defaults()  const { return *m_defaults; }
 
+        // Comparison of two configs of type T over the interned option keys: The i-th option of m_keys is found at m_offsets[i]
+        // of a T instance, therefore neither the keys are copied nor the options are looked up by their names as in ConfigBase::diff().
+        t_config_option_keys diff(const T &lhs, const T &rhs) const
+        {
+            t_config_option_keys out;
+            for (size_t i = 0; i < m_offsets.size(); ++ i)
+                if (*this->opt(lhs, i) != *this->opt(rhs, i))
+                    out.emplace_back(m_keys[i]);
+            return out;
+        }
+
+        bool                equals(const T &lhs, const T &rhs) const
+        {
+            for (size_t i = 0; i < m_offsets.size(); ++ i)
+                if (*this->opt(lhs, i) != *this->opt(rhs, i))
+                    return false;
+            return true;
+        }
+
+        // Hash of all the option values of a config. Equal configs hash equal.
+        uint64_t            hash(const T &owner) const
+        {
+            uint64_t h = 0;
+            for (size_t i = 0; i < m_offsets.size(); ++ i)
+                h = config_hash_combine(h, this->opt(owner, i)->hash());
+            return h;
+        }
+
         // To be called during the StaticCache setup.
         // Collect option keys from m_map_name_to_offset,
         // assign default values to m_defaults.
@@ -298,6 +331,8 @@ protected:
             m_defaults = defaults;
             m_keys.clear();
             m_keys.reserve(m_map_name_to_offset.size());
+            m_offsets.clear();
+            m_offsets.reserve(m_map_name_to_offset.size());
             for (const auto &kvp : defs->options) {
                 // Find the option given the option name kvp.first by an offset from (char*)m_defaults.
                 ConfigOption *opt = this->optptr(kvp.first, m_defaults);
@@ -305,6 +340,7 @@ protected:
                     // This option is not defined by the ConfigBase of type T.
                     continue;
                 m_keys.emplace_back(kvp.first);
+                m_offsets.emplace_back((const char*)opt - (const char*)m_defaults);
                 const ConfigOptionDef *def = defs->get(kvp.first);
                 assert(def != nullptr);
                 if (def->default_value != nullptr)
@@ -313,8 +349,13 @@ protected:
         }
 
     private:
+        const ConfigOption* opt(const T &owner, size_t idx) const
+            { return reinterpret_cast<const ConfigOption*>((const char*)&owner + m_offsets[idx]); }
+
         T                                  *m_defaults;
         std::vector<std::string>            m_keys;
+        // Offsets of the options of m_keys from the start of T.
+        std::vector<ptrdiff_t>              m_offsets;
     };
 };
 
@@ -326,6 +367,16 @@ public: \
     /* Overrides ConfigBase::keys(). Collect names of all configuration values maintained by this configuration store. */ \
     t_config_option_keys     keys() const override { return s_cache_##CLASS_NAME.keys(); } \
     static const CLASS_NAME& defaults() { initialize_cache(); return s_cache_##CLASS_NAME.defaults(); } \
+    /* Comparison with another config of the same type by the option offsets, see StaticCache::diff(). */ \
+    /* If this is a base of a more derived config, all the options of the derived config are compared by ConfigBase::diff(). */ \
+    using ConfigBase::diff; \
+    using ConfigBase::equals; \
+    t_config_option_keys     diff(const CLASS_NAME &other) const \
+        { return (typeid(*this) == typeid(CLASS_NAME)) ? s_cache_##CLASS_NAME.diff(*this, other) : ConfigBase::diff(other); } \
+    bool                     equals(const CLASS_NAME &other) const \
+        { return (typeid(*this) == typeid(CLASS_NAME)) ? s_cache_##CLASS_NAME.equals(*this, other) : ConfigBase::equals(other); } \
+    /* Hash of the values of the options of CLASS_NAME. */ \
+    uint64_t                 hash() const { initialize_cache(); return s_cache_##CLASS_NAME.hash(*this); } \
 private: \
     static void initialize_cache() \
     { \
@@ -2,15 +2,16 @@
 #define PRINTEXPORT_HPP
 
 // For png export of the sliced model
-#include <fstream>
+#include <atomic>
 #include <sstream>
 #include <vector>
 
 #include <boost/log/trivial.hpp>
 
+#include <tbb/pipeline.h>
+#include <tbb/task_scheduler_init.h>
+
 #include "Rasterizer/Rasterizer.hpp"
-//#include <tbb/parallel_for.h>
-//#include <tbb/spin_mutex.h>//#include "tbb/mutex.h"
 
 namespace Slic3r {
 
@@ -42,39 +43,21 @@ template<FilePrinterFormat format>
 class FilePrinter {
 public:
 
-    // Draw an ExPolygon which is a polygon inside a slice on the specified layer.
-    void draw_polygon(const ExPolygon& p, unsigned lyr);
-
     // Tell the printer how many layers should it consider.
     void layers(unsigned layernum);
 
     // Get the number of layers in the print.
     unsigned layers() const;
 
-    /* Switch to a particular layer. If there where less layers then the
-     * specified layer number than an appropriate number of layers will be
-     * allocated in the printer.
-     */
-    void begin_layer(unsigned layer);
-
-    // Allocate a new layer on top of the last and switch to it.
-    void begin_layer();
-
     /*
-     * Finish the selected layer. It means that no drawing is allowed on that
-     * layer anymore. This fact can be used to prepare the file system output
-     * data like png comprimation and so on.
+     * Save all the layers into the file (or dir) specified in the path
+     * argument. The layers are drawn only while they are being saved:
+     * draw_layer(canvas, layer) draws the slices of a layer onto the canvas
+     * of the output format, on_layer_saved(layer) is called after the layer
+     * has been saved.
      */
-    void finish_layer(unsigned layer);
-
-    // Finish the top layer.
-    void finish_layer();
-
-    // Save all the layers into the file (or dir) specified in the path argument
-    void save(const std::string& path);
-
-    // Save only the selected layer to the file specified in path argument.
-    void save_layer(unsigned lyr, const std::string& path);
+    template<class LyrFmt, class DrawFn, class SavedFn>
+    void save(const std::string& path, DrawFn draw_layer, SavedFn on_layer_saved);
 };
 
 // Provokes static_assert in the right way.
@@ -105,24 +88,12 @@ public:
 };
 
 // Implementation for PNG raster output
-// Be aware that if a large number of layers are allocated, it can very well
-// exhaust the available memory especially on 32 bit platform.
+// The layers are rasterized and compressed to PNG only while they are being
+// saved into the archive, so that just a few rasters and PNG images are held
+// in memory at any time, regardless of the number of layers.
 template<> class FilePrinter<FilePrinterFormat::SLA_PNGZIP>
 {
-    struct Layer {
-        Raster first;
-        std::stringstream second;
-
-        Layer() {}
-
-        Layer(const Layer&) = delete;
-        Layer(Layer&& m):
-            first(std::move(m.first))/*, second(std::move(m.second))*/ {}
-    };
-
-    // We will save the compressed PNG data into stringstreams which can be done
-    // in parallel. Later we can write every layer to the disk sequentially.
-    std::vector<Layer> m_layers_rst;
+    unsigned m_layer_count = 0;
     Raster::Resolution m_res;
     Raster::PixelDim m_pxdim;
     double m_exp_time_s = .0, m_exp_time_first_s = .0;
@@ -202,45 +173,17 @@ public:
 
     FilePrinter(const FilePrinter& ) = delete;
     FilePrinter(FilePrinter&& m):
-        m_layers_rst(std::move(m.m_layers_rst)),
+        m_layer_count(m.m_layer_count),
         m_res(m.m_res),
         m_pxdim(m.m_pxdim) {}
 
-    inline void layers(unsigned cnt) { if(cnt > 0) m_layers_rst.resize(cnt); }
-    inline unsigned layers() const { return unsigned(m_layers_rst.size()); }
-
-    inline void draw_polygon(const ExPolygon& p, unsigned lyr) {
-        assert(lyr < m_layers_rst.size());
-        m_layers_rst[lyr].first.draw(p);
-    }
-
-    inline void begin_layer(unsigned lyr) {
-        if(m_layers_rst.size() <= lyr) m_layers_rst.resize(lyr+1);
-        m_layers_rst[lyr].first.reset(m_res, m_pxdim, m_o);
-    }
-
-    inline void begin_layer() {
-        m_layers_rst.emplace_back();
-        m_layers_rst.front().first.reset(m_res, m_pxdim, m_o);
-    }
-
-    inline void finish_layer(unsigned lyr_id) {
-        assert(lyr_id < m_layers_rst.size());
-        m_layers_rst[lyr_id].first.save(m_layers_rst[lyr_id].second,
-                                       Raster::Compression::PNG);
-        m_layers_rst[lyr_id].first.reset();
-    }
-
-    inline void finish_layer() {
-        if(!m_layers_rst.empty()) {
-            m_layers_rst.back().first.save(m_layers_rst.back().second,
-                                          Raster::Compression::PNG);
-            m_layers_rst.back().first.reset();
-        }
-    }
+    inline void layers(unsigned cnt) { m_layer_count = cnt; }
+    inline unsigned layers() const { return m_layer_count; }
 
-    template<class LyrFmt>
-    inline void save(const std::string& path) {
+    template<class LyrFmt, class DrawFn, class SavedFn>
+    inline void save(const std::string& path, DrawFn draw_layer,
+                     SavedFn on_layer_saved)
+    {
         try {
             LayerWriter<LyrFmt> writer(path);
             if(!writer.is_ok()) return;
@@ -252,22 +195,42 @@ public:
 
             writer << createIniContent(project);
 
-            for(unsigned i = 0; i < m_layers_rst.size() && writer.is_ok(); i++)
-            {
-                if(m_layers_rst[i].second.rdbuf()->in_avail() > 0) {
-                    char lyrnum[6];
-                    std::sprintf(lyrnum, "%.5d", i);
-                    auto zfilename = project + lyrnum + ".png";
-                    writer.next_entry(zfilename);
-
-                    if(!writer.is_ok()) break;
-
-                    writer << m_layers_rst[i].second.str();
-                    // writer << m_layers_rst[i].second.rdbuf();
-                    // we can keep the date for later calls of this method
-                    //m_layers_rst[i].second.str("");
-                }
-            }
+            // The layers are rasterized and compressed in parallel, then
+            // written into the archive sequentially in their order. The number
+            // of layers in flight is limited to bound the memory consumption.
+            using LayerPNG = std::pair<unsigned, std::string>;
+            unsigned lyr_id = 0;
+            std::atomic<bool> writer_ok(true);
+            tbb::parallel_pipeline(
+                2 * size_t(tbb::task_scheduler_init::default_num_threads()),
+                tbb::make_filter<void, unsigned>(tbb::filter::serial_in_order,
+                    [this, &lyr_id, &writer_ok](tbb::flow_control &fc) -> unsigned {
+                        if(lyr_id == m_layer_count || !writer_ok) {
+                            fc.stop();
+                            return 0;
+                        }
+                        return lyr_id ++;
+                    }) &
+                tbb::make_filter<unsigned, LayerPNG>(tbb::filter::parallel,
+                    [this, &draw_layer](unsigned lyr) -> LayerPNG {
+                        Raster raster(m_res, m_pxdim, m_o);
+                        draw_layer(raster, lyr);
+                        std::stringstream png;
+                        raster.save(png, Raster::Compression::PNG);
+                        return LayerPNG(lyr, png.str());
+                    }) &
+                tbb::make_filter<LayerPNG, void>(tbb::filter::serial_in_order,
+                    [&project, &writer, &writer_ok, &on_layer_saved](const LayerPNG &layer) {
+                        if(!writer_ok) return;
+                        char lyrnum[6];
+                        std::sprintf(lyrnum, "%.5d", layer.first);
+                        auto zfilename = project + lyrnum + ".png";
+                        writer.next_entry(zfilename);
+                        if(writer.is_ok())
+                            writer << layer.second;
+                        writer_ok = writer.is_ok();
+                        on_layer_saved(layer.first);
+                    }));
         } catch(std::exception& e) {
             BOOST_LOG_TRIVIAL(error) << e.what();
             // Rethrow the exception
@@ -275,25 +238,6 @@ public:
         }
     }
 
-    void save_layer(unsigned lyr, const std::string& path) {
-        unsigned i = lyr;
-        assert(i < m_layers_rst.size());
-
-        char lyrnum[6];
-        std::sprintf(lyrnum, "%.5d", lyr);
-        std::string loc = path + "layer" + lyrnum + ".png";
-
-        std::fstream out(loc, std::fstream::out | std::fstream::binary);
-        if(out.good()) {
-            m_layers_rst[i].first.save(out, Raster::Compression::PNG);
-        } else {
-            BOOST_LOG_TRIVIAL(error) << "Can't create file for layer";
-        }
-
-        out.close();
-        m_layers_rst[i].first.reset();
-    }
-
     void set_statistics(const std::vector<double> statistics)
     {
         if (statistics.size() != psCnt)
@@ -102,7 +102,7 @@ void PrintObject::slice()
 {
     if (! this->set_started(posSlice))
         return;
-    m_print->set_status(10, "Processing triangulated mesh");
+    this->set_status(10, "Processing triangulated mesh");
     std::vector<coordf_t> layer_height_profile;
     this->update_layer_height_profile(*this->model_object(), m_slicing_params, layer_height_profile);
     m_print->throw_if_canceled();
@@ -122,6 +122,12 @@ void PrintObject::slice()
     this->set_done(posSlice);
 }
 
+void PrintObject::set_status(int percent, const std::string &message)
+{
+    if (! m_print->m_objects_concurrent)
+        m_print->set_status(percent, message);
+}
+
 // 1) Merges typed region slices into stInternal type.
 // 2) Increases an "extra perimeters" counter at region slices where needed.
 // 3) Generates perimeters, gap fills and fill regions (fill regions of type stInternal).
@@ -133,7 +139,7 @@ void PrintObject::make_perimeters()
     if (! this->set_started(posPerimeters))
         return;
 
-    m_print->set_status(20, "Generating perimeters");
+    this->set_status(20, "Generating perimeters");
     BOOST_LOG_TRIVIAL(info) << "Generating perimeters..." << log_memory_info();
     
     // merge slices if they were split into types
@@ -243,7 +249,7 @@ void PrintObject::prepare_infill()
     if (! this->set_started(posPrepareInfill))
         return;
 
-    m_print->set_status(30, "Preparing infill");
+    this->set_status(30, "Preparing infill");
 
     // This will assign a type (top/bottom/internal) to $layerm->slices.
     // Then the classifcation of $layerm->slices is transfered onto 
@@ -359,6 +365,7 @@ void PrintObject::infill()
     this->prepare_infill();
 
     if (this->set_started(posInfill)) {
+        this->set_status(70, "Infilling layers");
         BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - start";
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, m_layers.size()),
@@ -383,7 +390,7 @@ void PrintObject::generate_support_material()
     if (this->set_started(posSupportMaterial)) {
         this->clear_support_layers();
         if ((m_config.support_material || m_config.raft_layers > 0) && m_layers.size() > 1) {
-            m_print->set_status(85, "Generating support material");    
+            this->set_status(85, "Generating support material");
             this->_generate_support_material();
             m_print->throw_if_canceled();
         } else {
@@ -763,22 +770,34 @@ void PrintObject::detect_surfaces_type()
         #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
                     layerm->export_region_slices_to_svg_debug("detect_surfaces_type-final");
         #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+
+                    if (! interface_shells) {
+                        // The neighbor layers are only compared against the merged layer->slices, which are not modified here,
+                        // therefore the fill_surfaces of this layer may be trimmed right away without waiting for the other layers.
+                        layerm->slices_to_fill_surfaces_clipped();
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+                        layerm->export_region_fill_surfaces_to_svg_debug("1_detect_surfaces_type-final");
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+                    }
                 }
             }
         ); // for each layer of a region
         m_print->throw_if_canceled();
 
-        if (interface_shells) {
-            // Move surfaces_new to layerm->slices.surfaces
-            for (size_t idx_layer = 0; idx_layer < m_layers.size(); ++ idx_layer)
-                m_layers[idx_layer]->get_region(idx_region)->slices.surfaces = std::move(surfaces_new[idx_layer]);
+        if (! interface_shells) {
+            BOOST_LOG_TRIVIAL(debug) << "Detecting solid surfaces for region " << idx_region << " in parallel - end";
+            continue;
         }
 
+        // Move surfaces_new to layerm->slices.surfaces
+        for (size_t idx_layer = 0; idx_layer < m_layers.size(); ++ idx_layer)
+            m_layers[idx_layer]->get_region(idx_region)->slices.surfaces = std::move(surfaces_new[idx_layer]);
+
         BOOST_LOG_TRIVIAL(debug) << "Detecting solid surfaces for region " << idx_region << " - clipping in parallel - start";
         // Fill in layerm->fill_surfaces by trimming the layerm->slices by the cummulative layerm->fill_surfaces.
         tbb::parallel_for(
             tbb::blocked_range<size_t>(0, m_layers.size()),
-            [this, idx_region, interface_shells, &surfaces_new](const tbb::blocked_range<size_t>& range) {
+            [this, idx_region](const tbb::blocked_range<size_t>& range) {
                 for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
                     m_print->throw_if_canceled();
                     LayerRegion *layerm = m_layers[idx_layer]->get_region(idx_region);
@@ -827,99 +846,24 @@ void PrintObject::discover_vertical_shells()
 
     struct DiscoverVerticalShellsCacheEntry
     {
-        // Collected polygons, offsetted
-        Polygons    top_surfaces;
-        Polygons    bottom_surfaces;
-        Polygons    holes;
+        // Collected polygons, offsetted. Indexed by a region, or a single entry for all regions if top_bottom_surfaces_all_regions.
+        std::vector<Polygons> top_surfaces;
+        std::vector<Polygons> bottom_surfaces;
+        Polygons              holes;
     };
-    std::vector<DiscoverVerticalShellsCacheEntry> cache_top_botom_regions(m_layers.size(), DiscoverVerticalShellsCacheEntry());
     bool top_bottom_surfaces_all_regions = this->region_volumes.size() > 1 && ! m_config.interface_shells.value;
-    if (top_bottom_surfaces_all_regions) {
-        // This is a multi-material print and interface_shells are disabled, meaning that the vertical shell thickness
-        // is calculated over all materials.
-        // Is the "ensure vertical wall thickness" applicable to any region?
-        bool has_extra_layers = false;
-        for (size_t idx_region = 0; idx_region < this->region_volumes.size(); ++ idx_region) {
-            const PrintRegion &region = *m_print->get_region(idx_region);
-            if (region.config().ensure_vertical_shell_thickness.value && 
-                (region.config().top_solid_layers.value > 1 || region.config().bottom_solid_layers.value > 1)) {
-                has_extra_layers = true;
-            }
-        }
-        if (! has_extra_layers)
-            // The "ensure vertical wall thickness" feature is not applicable to any of the regions. Quit.
-            return;
-        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells in parallel - start : cache top / bottom";
-        //FIXME Improve the heuristics for a grain size.
-        size_t grain_size = std::max(m_layers.size() / 16, size_t(1));
-        tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size(), grain_size),
-            [this, &cache_top_botom_regions](const tbb::blocked_range<size_t>& range) {
-                const SurfaceType surfaces_bottom[2] = { stBottom, stBottomBridge };
-                const size_t num_regions = this->region_volumes.size();
-                for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
-                    m_print->throw_if_canceled();
-                    const Layer                      &layer = *m_layers[idx_layer];
-                    DiscoverVerticalShellsCacheEntry &cache = cache_top_botom_regions[idx_layer];
-                    // Simulate single set of perimeters over all merged regions.
-                    float                             perimeter_offset = 0.f;
-                    float                             perimeter_min_spacing = FLT_MAX;
-#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
-                    static size_t debug_idx = 0;
-                    ++ debug_idx;
-#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
-                    for (size_t idx_region = 0; idx_region < num_regions; ++ idx_region) {
-                        LayerRegion &layerm                       = *layer.m_regions[idx_region];
-                        float        min_perimeter_infill_spacing = float(layerm.flow(frSolidInfill).scaled_spacing()) * 1.05f;
-                        // Top surfaces.
-                        append(cache.top_surfaces, offset(to_expolygons(layerm.slices.filter_by_type(stTop)), min_perimeter_infill_spacing));
-                        append(cache.top_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_type(stTop)), min_perimeter_infill_spacing));
-                        // Bottom surfaces.
-                        append(cache.bottom_surfaces, offset(to_expolygons(layerm.slices.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
-                        append(cache.bottom_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
-                        // Calculate the maximum perimeter offset as if the slice was extruded with a single extruder only.
-                        // First find the maxium number of perimeters per region slice.
-                        unsigned int perimeters = 0;
-                        for (Surface &s : layerm.slices.surfaces)
-                            perimeters = std::max<unsigned int>(perimeters, s.extra_perimeters);
-                        perimeters += layerm.region()->config().perimeters.value;
-                        // Then calculate the infill offset.
-                        if (perimeters > 0) {
-                            Flow extflow = layerm.flow(frExternalPerimeter);
-                            Flow flow    = layerm.flow(frPerimeter);
-                            perimeter_offset = std::max(perimeter_offset,
-                                0.5f * float(extflow.scaled_width() + extflow.scaled_spacing()) + (float(perimeters) - 1.f) * flow.scaled_spacing());
-                            perimeter_min_spacing = std::min(perimeter_min_spacing, float(std::min(extflow.scaled_spacing(), flow.scaled_spacing())));
-                        }
-                        polygons_append(cache.holes, to_polygons(layerm.fill_expolygons));
-                    }
-                    // Save some computing time by reducing the number of polygons.
-                    cache.top_surfaces    = union_(cache.top_surfaces,    false);
-                    cache.bottom_surfaces = union_(cache.bottom_surfaces, false);
-                    // For a multi-material print, simulate perimeter / infill split as if only a single extruder has been used for the whole print.
-                    if (perimeter_offset > 0.) {
-                        // The layer.slices are forced to merge by expanding them first.
-                        polygons_append(cache.holes, offset(offset_ex(layer.slices, 0.3f * perimeter_min_spacing), - perimeter_offset - 0.3f * perimeter_min_spacing));
-#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
-                        {
-                            Slic3r::SVG svg(debug_out_path("discover_vertical_shells-extra-holes-%d.svg", debug_idx), get_extents(layer.slices.expolygons));
-                            svg.draw(layer.slices.expolygons, "blue");
-                            svg.draw(union_ex(cache.holes), "red");
-                            svg.draw_outline(union_ex(cache.holes), "black", "blue", scale_(0.05));
-                            svg.Close(); 
-                        }
-#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
-                    }
-                    cache.holes = union_(cache.holes, false);
-                }
-            });
-        m_print->throw_if_canceled();
-        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells in parallel - end : cache top / bottom";
-    }
 
+    // Collect the regions, to which the "ensure vertical wall thickness" is applicable.
+    struct RegionShells
+    {
+        size_t idx_region;
+        int    n_extra_top_layers;
+        int    n_extra_bottom_layers;
+    };
+    std::vector<RegionShells> regions;
+    int n_extra_top_layers_max    = 0;
+    int n_extra_bottom_layers_max = 0;
     for (size_t idx_region = 0; idx_region < this->region_volumes.size(); ++ idx_region) {
-        PROFILE_BLOCK(discover_vertical_shells_region);
-
         const PrintRegion &region = *m_print->get_region(idx_region);
         if (! region.config().ensure_vertical_shell_thickness.value)
             // This region will be handled by discover_horizontal_shells().
@@ -929,45 +873,41 @@ void PrintObject::discover_vertical_shells()
         if (n_extra_top_layers + n_extra_bottom_layers == 0)
             // Zero or 1 layer, there is no additional vertical wall thickness enforced.
             continue;
+        regions.push_back({ idx_region, n_extra_top_layers, n_extra_bottom_layers });
+        n_extra_top_layers_max    = std::max(n_extra_top_layers_max,    n_extra_top_layers);
+        n_extra_bottom_layers_max = std::max(n_extra_bottom_layers_max, n_extra_bottom_layers);
+    }
+    if (regions.empty())
+        // The "ensure vertical wall thickness" feature is not applicable to any of the regions. Quit.
+        return;
+
+    // The cached top / bottom surfaces of a layer are only needed while the layers inside its window of the extra solid layers
+    // are being processed. Therefore the object is processed in bands of layers: The cache is filled in for the band
+    // extended by the window above, then the band is processed and the cache entries below the window of the next band are released.
+    // The peak memory of the cache is then proportional to the band size instead of to the number of layers of the object.
+    // Each band ends with a barrier, therefore the bands are made long enough to split into several chunks of work per thread.
+    size_t num_threads = size_t(tbb::task_scheduler_init::default_num_threads());
+    size_t band_size   = std::max(16 * num_threads, size_t(4 * (n_extra_bottom_layers_max + n_extra_top_layers_max + 1)));
+    //FIXME Improve the heuristics for a grain size.
+    auto   grain_size  = [num_threads](size_t num_layers) { return std::max(num_layers / (4 * num_threads), size_t(1)); };
+    std::vector<DiscoverVerticalShellsCacheEntry> cache_top_botom_regions(m_layers.size(), DiscoverVerticalShellsCacheEntry());
 
-        //FIXME Improve the heuristics for a grain size.
-        size_t grain_size = std::max(m_layers.size() / 16, size_t(1));
+    // Ensure the vertical wall thickness of a region over a band of layers, reading the cached top / bottom surfaces
+    // of the layers inside the window of the extra solid layers.
+    auto discover_region_shells = [this, top_bottom_surfaces_all_regions, &grain_size, &cache_top_botom_regions]
+        (const RegionShells &region_shells, size_t band_begin, size_t band_end) {
+        PROFILE_BLOCK(discover_vertical_shells_region);
 
-        if (! top_bottom_surfaces_all_regions) {
-            // This is either a single material print, or a multi-material print and interface_shells are enabled, meaning that the vertical shell thickness
-            // is calculated over a single material.
-            BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << idx_region << " in parallel - start : cache top / bottom";
-            tbb::parallel_for(
-                tbb::blocked_range<size_t>(0, m_layers.size(), grain_size),
-                [this, idx_region, &cache_top_botom_regions](const tbb::blocked_range<size_t>& range) {
-                    const SurfaceType surfaces_bottom[2] = { stBottom, stBottomBridge };
-                    for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
-                        m_print->throw_if_canceled();
-                        Layer       &layer                        = *m_layers[idx_layer];
-                        LayerRegion &layerm                       = *layer.m_regions[idx_region];
-                        float        min_perimeter_infill_spacing = float(layerm.flow(frSolidInfill).scaled_spacing()) * 1.05f;
-                        // Top surfaces.
-                        auto &cache = cache_top_botom_regions[idx_layer];
-                        cache.top_surfaces = offset(to_expolygons(layerm.slices.filter_by_type(stTop)), min_perimeter_infill_spacing);
-                        append(cache.top_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_type(stTop)), min_perimeter_infill_spacing));
-                        // Bottom surfaces.
-                        cache.bottom_surfaces = offset(to_expolygons(layerm.slices.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing);
-                        append(cache.bottom_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
-                        // Holes over all regions. Only collect them once, they are valid for all idx_region iterations.
-                        if (cache.holes.empty()) {
-                            for (size_t idx_region = 0; idx_region < layer.regions().size(); ++ idx_region)
-                                polygons_append(cache.holes, to_polygons(layer.regions()[idx_region]->fill_expolygons));
-                        }
-                    }
-                });
-            m_print->throw_if_canceled();
-            BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << idx_region << " in parallel - end : cache top / bottom";
-        }
+        size_t idx_region            = region_shells.idx_region;
+        int    n_extra_top_layers    = region_shells.n_extra_top_layers;
+        int    n_extra_bottom_layers = region_shells.n_extra_bottom_layers;
+        // Index of the top / bottom surfaces of this region in the cache entries.
+        size_t idx_cache             = top_bottom_surfaces_all_regions ? 0 : idx_region;
 
-        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << idx_region << " in parallel - start : ensure vertical wall thickness";
+        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << idx_region << " in parallel - start : ensure vertical wall thickness of layers " << band_begin << " to " << band_end;
         tbb::parallel_for(
-            tbb::blocked_range<size_t>(0, m_layers.size(), grain_size),
-            [this, idx_region, n_extra_top_layers, n_extra_bottom_layers, &cache_top_botom_regions]
+            tbb::blocked_range<size_t>(band_begin, band_end, grain_size(band_end - band_begin)),
+            [this, idx_region, idx_cache, n_extra_top_layers, n_extra_bottom_layers, &cache_top_botom_regions]
             (const tbb::blocked_range<size_t>& range) {
                 // printf("discover_vertical_shells from %d to %d\n", range.begin(), range.end());
                 for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
@@ -1023,7 +963,6 @@ void PrintObject::discover_vertical_shells()
                         bool hole_first = true;
                         for (int n = (int)idx_layer - n_extra_bottom_layers; n <= (int)idx_layer + n_extra_top_layers; ++ n)
                             if (n >= 0 && n < (int)m_layers.size()) {
-                                Layer &neighbor_layer = *m_layers[n];
                                 const DiscoverVerticalShellsCacheEntry &cache = cache_top_botom_regions[n];
                                 if (hole_first) {
                                     hole_first = false;
@@ -1035,10 +974,10 @@ void PrintObject::discover_vertical_shells()
                                 size_t n_shell_old = shell.size();
                                 if (n > int(idx_layer))
                                     // Collect top surfaces.
-                                    polygons_append(shell, cache.top_surfaces);
+                                    polygons_append(shell, cache.top_surfaces[idx_cache]);
                                 else if (n < int(idx_layer))
                                     // Collect bottom and bottom bridge surfaces.
-                                    polygons_append(shell, cache.bottom_surfaces);
+                                    polygons_append(shell, cache.bottom_surfaces[idx_cache]);
                                 // Running the union_ using the Clipper library piece by piece is cheaper 
                                 // than running the union_ all at once.
                                 if (n_shell_old < shell.size())
@@ -1188,15 +1127,124 @@ void PrintObject::discover_vertical_shells()
             });
         m_print->throw_if_canceled();
         BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells for region " << idx_region << " in parallel - end";
+    };
+
+    size_t num_cached = 0;
+    for (size_t band_begin = 0; band_begin < m_layers.size(); band_begin += band_size) {
+        size_t band_end  = std::min(band_begin + band_size, m_layers.size());
+        size_t cache_end = std::min(band_end + size_t(n_extra_top_layers_max), m_layers.size());
+
+        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells in parallel - start : cache top / bottom of layers " << num_cached << " to " << cache_end;
+        tbb::parallel_for(
+            tbb::blocked_range<size_t>(num_cached, cache_end, grain_size(cache_end - num_cached)),
+            [this, top_bottom_surfaces_all_regions, &regions, &cache_top_botom_regions](const tbb::blocked_range<size_t>& range) {
+                const SurfaceType surfaces_bottom[2] = { stBottom, stBottomBridge };
+                const size_t num_regions = this->region_volumes.size();
+                for (size_t idx_layer = range.begin(); idx_layer < range.end(); ++ idx_layer) {
+                    m_print->throw_if_canceled();
+                    const Layer                      &layer = *m_layers[idx_layer];
+                    DiscoverVerticalShellsCacheEntry &cache = cache_top_botom_regions[idx_layer];
+                    if (! top_bottom_surfaces_all_regions) {
+                        // This is either a single material print, or a multi-material print and interface_shells are enabled, meaning that the vertical shell thickness
+                        // is calculated over a single material.
+                        cache.top_surfaces.assign(num_regions, Polygons());
+                        cache.bottom_surfaces.assign(num_regions, Polygons());
+                        for (const RegionShells &region_shells : regions) {
+                            LayerRegion &layerm                       = *layer.m_regions[region_shells.idx_region];
+                            float        min_perimeter_infill_spacing = float(layerm.flow(frSolidInfill).scaled_spacing()) * 1.05f;
+                            // Top surfaces.
+                            Polygons    &top_surfaces                 = cache.top_surfaces[region_shells.idx_region];
+                            top_surfaces = offset(to_expolygons(layerm.slices.filter_by_type(stTop)), min_perimeter_infill_spacing);
+                            append(top_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_type(stTop)), min_perimeter_infill_spacing));
+                            // Bottom surfaces.
+                            Polygons    &bottom_surfaces              = cache.bottom_surfaces[region_shells.idx_region];
+                            bottom_surfaces = offset(to_expolygons(layerm.slices.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing);
+                            append(bottom_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
+                        }
+                        // Holes over all regions, they are valid for all the regions.
+                        for (size_t idx_region = 0; idx_region < layer.regions().size(); ++ idx_region)
+                            polygons_append(cache.holes, to_polygons(layer.regions()[idx_region]->fill_expolygons));
+                        continue;
+                    }
+                    // This is a multi-material print and interface_shells are disabled, meaning that the vertical shell thickness
+                    // is calculated over all materials.
+                    cache.top_surfaces.assign(1, Polygons());
+                    cache.bottom_surfaces.assign(1, Polygons());
+                    Polygons &top_surfaces    = cache.top_surfaces.front();
+                    Polygons &bottom_surfaces = cache.bottom_surfaces.front();
+                    // Simulate single set of perimeters over all merged regions.
+                    float                             perimeter_offset = 0.f;
+                    float                             perimeter_min_spacing = FLT_MAX;
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+                    static size_t debug_idx = 0;
+                    ++ debug_idx;
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+                    for (size_t idx_region = 0; idx_region < num_regions; ++ idx_region) {
+                        LayerRegion &layerm                       = *layer.m_regions[idx_region];
+                        float        min_perimeter_infill_spacing = float(layerm.flow(frSolidInfill).scaled_spacing()) * 1.05f;
+                        // Top surfaces.
+                        append(top_surfaces, offset(to_expolygons(layerm.slices.filter_by_type(stTop)), min_perimeter_infill_spacing));
+                        append(top_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_type(stTop)), min_perimeter_infill_spacing));
+                        // Bottom surfaces.
+                        append(bottom_surfaces, offset(to_expolygons(layerm.slices.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
+                        append(bottom_surfaces, offset(to_expolygons(layerm.fill_surfaces.filter_by_types(surfaces_bottom, 2)), min_perimeter_infill_spacing));
+                        // Calculate the maximum perimeter offset as if the slice was extruded with a single extruder only.
+                        // First find the maxium number of perimeters per region slice.
+                        unsigned int perimeters = 0;
+                        for (Surface &s : layerm.slices.surfaces)
+                            perimeters = std::max<unsigned int>(perimeters, s.extra_perimeters);
+                        perimeters += layerm.region()->config().perimeters.value;
+                        // Then calculate the infill offset.
+                        if (perimeters > 0) {
+                            Flow extflow = layerm.flow(frExternalPerimeter);
+                            Flow flow    = layerm.flow(frPerimeter);
+                            perimeter_offset = std::max(perimeter_offset,
+                                0.5f * float(extflow.scaled_width() + extflow.scaled_spacing()) + (float(perimeters) - 1.f) * flow.scaled_spacing());
+                            perimeter_min_spacing = std::min(perimeter_min_spacing, float(std::min(extflow.scaled_spacing(), flow.scaled_spacing())));
+                        }
+                        polygons_append(cache.holes, to_polygons(layerm.fill_expolygons));
+                    }
+                    // Save some computing time by reducing the number of polygons.
+                    top_surfaces    = union_(top_surfaces,    false);
+                    bottom_surfaces = union_(bottom_surfaces, false);
+                    // For a multi-material print, simulate perimeter / infill split as if only a single extruder has been used for the whole print.
+                    if (perimeter_offset > 0.) {
+                        // The layer.slices are forced to merge by expanding them first.
+                        polygons_append(cache.holes, offset(offset_ex(layer.slices, 0.3f * perimeter_min_spacing), - perimeter_offset - 0.3f * perimeter_min_spacing));
+#ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+                        {
+                            Slic3r::SVG svg(debug_out_path("discover_vertical_shells-extra-holes-%d.svg", debug_idx), get_extents(layer.slices.expolygons));
+                            svg.draw(layer.slices.expolygons, "blue");
+                            svg.draw(union_ex(cache.holes), "red");
+                            svg.draw_outline(union_ex(cache.holes), "black", "blue", scale_(0.05));
+                            svg.Close(); 
+                        }
+#endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
+                    }
+                    cache.holes = union_(cache.holes, false);
+                }
+            });
+        m_print->throw_if_canceled();
+        num_cached = cache_end;
+        BOOST_LOG_TRIVIAL(debug) << "Discovering vertical shells in parallel - end : cache top / bottom";
+
+        for (const RegionShells &region_shells : regions)
+            discover_region_shells(region_shells, band_begin, band_end);
+
+        // Release the cache entries, which are below the window of the next band.
+        for (size_t idx_layer = (band_begin > size_t(n_extra_bottom_layers_max)) ? band_begin - n_extra_bottom_layers_max : 0;
+             idx_layer + n_extra_bottom_layers_max < band_end; ++ idx_layer)
+            cache_top_botom_regions[idx_layer] = DiscoverVerticalShellsCacheEntry();
+    } // for each band of layers
 
 #ifdef SLIC3R_DEBUG_SLICE_PROCESSING
+    for (const RegionShells &region_shells : regions)
 		for (size_t idx_layer = 0; idx_layer < m_layers.size(); ++idx_layer) {
-			LayerRegion *layerm = m_layers[idx_layer]->get_region(idx_region);
+			LayerRegion *layerm = m_layers[idx_layer]->get_region(region_shells.idx_region);
 			layerm->export_region_slices_to_svg_debug("4_discover_vertical_shells-final");
 			layerm->export_region_fill_surfaces_to_svg_debug("4_discover_vertical_shells-final");
 		}
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
-    } // for each region
 
     // Write the profiler measurements to file
 //    PROFILE_UPDATE();
@@ -1,6 +1,7 @@
 #include "Rasterizer.hpp"
 #include <ExPolygon.hpp>
 
+#include <algorithm>
 #include <cstdint>
 
 // For rasterizing
@@ -17,6 +18,7 @@
 
 // For png compression
 #include <png/writer.hpp>
+#include <zlib.h>
 
 namespace Slic3r {
 
@@ -175,6 +177,82 @@ void Raster::draw(const ExPolygon &poly)
     m_impl->draw(poly);
 }
 
+namespace {
+
+// Append the pixels [begin, end) as TGA run-length packets: a run packet
+// repeats a single pixel up to 128 times, a raw packet stores up to 128
+// pixels which do not repeat.
+void rle_encode(const std::uint8_t *begin, const std::uint8_t *end,
+                std::string& out)
+{
+    for(const std::uint8_t *p = begin; p != end;) {
+        const std::uint8_t *run = p + 1;
+        while(run != end && *run == *p && run - p < 128) ++run;
+        if(run - p > 1) {
+            out += char(0x80 | (run - p - 1));
+            out += char(*p);
+            p = run;
+        } else {
+            // Collect the pixels up to the next run of at least 3 pixels,
+            // a shorter run is not worth splitting the raw packet.
+            const std::uint8_t *raw = p + 1;
+            while(raw != end && raw - p < 128 &&
+                  ! (raw + 2 < end && raw[0] == raw[1] && raw[1] == raw[2]))
+                ++raw;
+            out += char(raw - p - 1);
+            out.append(reinterpret_cast<const char*>(p), size_t(raw - p));
+            p = raw;
+        }
+    }
+}
+
+// Append a run of n black pixels.
+void rle_black(size_t n, std::string& out)
+{
+    for(; n >= 128; n -= 128) { out += char(0xFF); out += char(0); }
+    if(n > 0) { out += char(0x80 | (n - 1)); out += char(0); }
+}
+
+// Write the 8 bit grayscale image as a run-length encoded TGA.
+void save_rle(std::ostream& stream, const std::uint8_t *pixels,
+              const Raster::Resolution& res)
+{
+    // TGA header: no image id, no color map, image type 11 (run-length
+    // encoded grayscale), 8 bits per pixel, the first row is the top one.
+    std::uint8_t header[18] = {};
+    header[2]  = 11;
+    header[12] = std::uint8_t(res.width_px & 0xFF);
+    header[13] = std::uint8_t(res.width_px >> 8);
+    header[14] = std::uint8_t(res.height_px & 0xFF);
+    header[15] = std::uint8_t(res.height_px >> 8);
+    header[16] = 8;
+    header[17] = 0x20;
+    stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    // Most of the rows are empty and the white areas of the others are
+    // narrow, only the part of a row between its first and last lit pixel
+    // is searched for runs, the black margins are written as long runs.
+    std::string out;
+    const std::uint8_t *row = pixels;
+    for(unsigned r = 0; r < res.height_px; ++r, row += res.width_px) {
+        const std::uint8_t *end = row + res.width_px;
+        const std::uint8_t *first = std::find_if(row, end,
+            [](std::uint8_t px) { return px != 0; });
+        if(first == end) {
+            rle_black(res.width_px, out);
+        } else {
+            const std::uint8_t *last = end;
+            while(*(last - 1) == 0) --last;
+            rle_black(size_t(first - row), out);
+            rle_encode(first, last, out);
+            rle_black(size_t(end - last), out);
+        }
+    }
+    stream.write(out.data(), std::streamsize(out.size()));
+}
+
+}
+
 void Raster::save(std::ostream& stream, Compression comp)
 {
     assert(m_impl);
@@ -189,6 +267,14 @@ void Raster::save(std::ostream& stream, Compression comp)
         wr.set_height(resolution().height_px);
         wr.set_compression_type(png::compression_type_default);
 
+        // The layers are mostly black with few gray levels at the edges of
+        // the white areas. Run-length matching of zlib without the PNG row
+        // filters is several times faster than the default adaptive filters
+        // with the full deflate search and it produces smaller files.
+        png_set_filter(wr.get_png_struct(), PNG_FILTER_TYPE_BASE,
+                       PNG_FILTER_NONE);
+        png_set_compression_strategy(wr.get_png_struct(), Z_RLE);
+
         wr.write_info();
 
         auto& b = m_impl->buffer();
@@ -213,6 +299,15 @@ void Raster::save(std::ostream& stream, Compression comp)
         auto sz = m_impl->buffer().size()*sizeof(Impl::TBuffer::value_type);
         stream.write(reinterpret_cast<const char*>(m_impl->buffer().data()),
                      std::streamsize(sz));
+        break;
+    }
+    case Compression::RLE: {
+        static_assert(sizeof(Impl::TBuffer::value_type) == 1,
+                      "The RLE output expects 8 bit grayscale pixels");
+        save_rle(stream,
+                 reinterpret_cast<const std::uint8_t*>(m_impl->buffer().data()),
+                 resolution());
+        break;
     }
     }
 }
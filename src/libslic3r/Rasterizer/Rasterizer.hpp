@@ -24,7 +24,8 @@ public:
     /// Supported compression types
     enum class Compression {
         RAW,    //!> Uncompressed pixel data
-        PNG     //!> PNG compression
+        PNG,    //!> PNG compression
+        RLE     //!> Run-length encoded grayscale TGA
     };
 
     /// The Rasterizer expects the input polygons to have their coordinate
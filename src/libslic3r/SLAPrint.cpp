@@ -8,7 +8,6 @@
 #include <unordered_set>
 #include <numeric>
 
-#include <tbb/parallel_for.h>
 #include <boost/filesystem/path.hpp>
 #include <boost/log/trivial.hpp>
 
@@ -598,6 +597,43 @@ void report_status(SLAPrint& p, int st, const std::string& msg, Args&&...args) {
 }
 
 
+void SLAPrint::draw_level(Raster& raster, unsigned level_id) const
+{
+    throw_if_canceled();
+
+    // If the raster has vertical orientation, we will flip the coordinates
+    bool flpXY = m_printer_config.display_orientation.getInt() ==
+            SLADisplayOrientation::sladoPortrait;
+
+    for(const LayerRef& lyrref : *m_printer_levels[level_id]) { // for all layers in the current level
+        const Layer& sl = lyrref.lref;   // get the layer reference
+        const LayerCopies& copies = lyrref.copies;
+
+        // Draw all the polygons in the slice to the actual layer.
+        for(auto& cp : copies) {
+            for(ExPolygon slice : sl) {
+                // The order is important here:
+                // apply rotation before translation...
+                slice.rotate(double(cp.rotation));
+                slice.translate(cp.shift(X), cp.shift(Y));
+                if(flpXY) swapXY(slice);
+                raster.draw(slice);
+            }
+        }
+    }
+}
+
+void SLAPrint::report_level_saved(unsigned level_id)
+{
+    // The export runs after process() reported "Slicing done" at 100%, so its
+    // progress gets its own label instead of restarting the rasterization.
+    // Report the progress only when the percentage changes.
+    auto cnt = m_printer_levels.size();
+    auto st = unsigned(100 * (level_id + 1) / cnt);
+    if(st != unsigned(100 * level_id / cnt))
+        report_status(*this, int(st), L("Exporting layers"));
+}
+
 void SLAPrint::process()
 {
     using namespace sla;
@@ -899,7 +935,7 @@ void SLAPrint::process()
     };
 
     // Rasterizing the model objects, and their supports
-    auto rasterize = [this, max_objstatus]() {
+    auto rasterize = [this]() {
         if(canceled()) return;
 
         // clear the rasterizer input
@@ -933,9 +969,10 @@ void SLAPrint::process()
             }
         }
 
-        // collect all the keys
-        std::vector<long long> keys; keys.reserve(m_printer_input.size());
-        for(auto& e : m_printer_input) keys.emplace_back(e.first);
+        // Index the levels in their order
+        m_printer_levels.clear();
+        m_printer_levels.reserve(m_printer_input.size());
+        for(auto& e : m_printer_input) m_printer_levels.emplace_back(&e.second);
 
         // If the raster has vertical orientation, we will flip the coordinates
         bool flpXY = m_printer_config.display_orientation.getInt() ==
@@ -962,71 +999,9 @@ void SLAPrint::process()
                                                   SLAPrinter::RO_LANDSCAPE));
         }
 
-        // Allocate space for all the layers
-        SLAPrinter& printer = *m_printer;
-        auto lvlcnt = unsigned(m_printer_input.size());
-        printer.layers(lvlcnt);
-
-        // slot is the portion of 100% that is realted to rasterization
-        unsigned slot = PRINT_STEP_LEVELS[slapsRasterize];
-        // ist: initial state; pst: previous state
-        unsigned ist = max_objstatus, pst = ist;
-        // coefficient to map the rasterization state (0-99) to the allocated
-        // portion (slot) of the process state
-        double sd = (100 - ist) / 100.0;
-        SpinMutex slck;
-
-        // procedure to process one height level. This will run in parallel
-        auto lvlfn =
-        [this, &slck, &keys, &printer, slot, sd, ist, &pst, flpXY]
-            (unsigned level_id)
-        {
-            if(canceled()) return;
-
-            LayerRefs& lrange = m_printer_input[keys[level_id]];
-
-            // Switch to the appropriate layer in the printer
-            printer.begin_layer(level_id);
-
-            for(auto& lyrref : lrange) { // for all layers in the current level
-                if(canceled()) break;
-                const Layer& sl = lyrref.lref;   // get the layer reference
-                const LayerCopies& copies = lyrref.copies;
-
-                // Draw all the polygons in the slice to the actual layer.
-                for(auto& cp : copies) {
-                    for(ExPolygon slice : sl) {
-                        // The order is important here:
-                        // apply rotation before translation...
-                        slice.rotate(double(cp.rotation));
-                        slice.translate(cp.shift(X), cp.shift(Y));
-                        if(flpXY) swapXY(slice);
-                        printer.draw_polygon(slice, level_id);
-                    }
-                }
-            }
-
-            // Finish the layer for later saving it.
-            printer.finish_layer(level_id);
-
-            // Status indication guarded with the spinlock
-            auto st = ist + unsigned(sd*level_id*slot/m_printer_input.size());
-            { std::lock_guard<SpinMutex> lck(slck);
-            if( st > pst) {
-                report_status(*this, int(st), PRINT_STEP_LABELS[slapsRasterize]);
-                pst = st;
-            }
-            }
-        };
-
-        // last minute escape
-        if(canceled()) return;
-
-        // Sequential version (for testing)
-        // for(unsigned l = 0; l < lvlcnt; ++l) process_level(l);
-
-        // Print all the layers in parallel
-        tbb::parallel_for<unsigned, decltype(lvlfn)>(0, lvlcnt, lvlfn);
+        // The layers are rasterized by draw_level() while the printer saves
+        // them, only a few layers are kept in memory at a time.
+        m_printer->layers(unsigned(m_printer_levels.size()));
 
         // Fill statistics
         this->fill_statistics();
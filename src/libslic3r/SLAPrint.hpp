@@ -231,8 +231,13 @@ public:
     // Returns true if the last step was finished with success.
 	bool                finished() const override { return this->is_step_done(slaposIndexSlices) && this->Inherited::is_step_done(slapsRasterize); }
 
+    // The layers are rasterized from the slices referenced by the printer
+    // input, which are only valid while the rasterization step is done.
     template<class Fmt> void export_raster(const std::string& fname) {
-        if(m_printer) m_printer->save<Fmt>(fname);
+        if(m_printer && this->Inherited::is_step_done(slapsRasterize))
+            m_printer->save<Fmt>(fname,
+                [this](Raster& raster, unsigned level_id) { this->draw_level(raster, level_id); },
+                [this](unsigned level_id) { this->report_level_saved(level_id); });
     }
     const PrintObjects& objects() const { return m_objects; }
 
@@ -254,6 +259,13 @@ private:
 
     void fill_statistics();
 
+    // Draw the slices of the objects and of their supports at a level of
+    // the printer input into the raster, called by the printer in parallel.
+    void draw_level(Raster& raster, unsigned level_id) const;
+
+    // Report the progress of rasterizing and saving the levels by the export.
+    void report_level_saved(unsigned level_id);
+
     SLAPrintConfig                  m_print_config;
     SLAPrinterConfig                m_printer_config;
     SLAMaterialConfig               m_material_config;
@@ -279,6 +291,9 @@ private:
     // supports
     using LayerRefs = std::vector<LayerRef>;
     std::map<LevelID, LayerRefs>            m_printer_input;
+    // The levels of m_printer_input in their order, indexed by the layers
+    // of the printer.
+    std::vector<const LayerRefs*>           m_printer_levels;
 
     // The printer itself
     SLAPrinterPtr                           m_printer;
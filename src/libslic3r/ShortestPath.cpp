@@ -0,0 +1,170 @@
+#include "ShortestPath.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace Slic3r {
+
+ClosestEndPointIndex::ClosestEndPointIndex(const Points &end_points, size_t ends_per_item, TieBreak tie_break) :
+    m_points(end_points), m_ends_per_item(ends_per_item), m_tie_break(tie_break),
+    m_removed(end_points.size() / ends_per_item, false), m_num_alive(end_points.size()),
+    m_origin(0, 0), m_cell_size(1), m_cols(0), m_rows(0), m_num_indexed(0)
+{
+    assert(ends_per_item == 1 || ends_per_item == 2);
+    assert(end_points.size() % ends_per_item == 0);
+    this->build_grid();
+}
+
+void ClosestEndPointIndex::build_grid()
+{
+    m_cell_start.clear();
+    m_cell_points.clear();
+    m_cell_alive.clear();
+    m_cols = m_rows = 0;
+    m_num_indexed = m_num_alive;
+    if (m_num_alive == 0)
+        return;
+
+    Point pmin( std::numeric_limits<coord_t>::max(),  std::numeric_limits<coord_t>::max());
+    Point pmax(-std::numeric_limits<coord_t>::max(), -std::numeric_limits<coord_t>::max());
+    for (size_t i = 0; i < m_points.size(); ++ i)
+        if (! m_removed[i / m_ends_per_item]) {
+            pmin = pmin.cwiseMin(m_points[i]);
+            pmax = pmax.cwiseMax(m_points[i]);
+        }
+
+    // Two end points per cell on average. Limit the number of the cells along the longer side of the bounding box
+    // to the number of the end points, if they are all on a line.
+    double w = double(pmax(0)) - double(pmin(0)) + 1.;
+    double h = double(pmax(1)) - double(pmin(1)) + 1.;
+    double n = double(m_num_alive);
+    double cell_size = std::max(std::sqrt(2. * w * h / n), std::max(w, h) / n);
+    m_cell_size = coord_t(std::min(std::ceil(cell_size), double(std::numeric_limits<coord_t>::max())));
+    m_origin    = pmin;
+    m_cols      = size_t(w / double(m_cell_size)) + 1;
+    m_rows      = size_t(h / double(m_cell_size)) + 1;
+
+    // Counting sort of the end points by their cells.
+    m_cell_start.assign(m_cols * m_rows + 1, 0);
+    m_cell_alive.assign(m_cols * m_rows, 0);
+    for (size_t i = 0; i < m_points.size(); ++ i)
+        if (! m_removed[i / m_ends_per_item])
+            ++ m_cell_alive[this->cell_y(m_points[i](1)) * m_cols + this->cell_x(m_points[i](0))];
+    for (size_t i = 0; i < m_cell_alive.size(); ++ i)
+        m_cell_start[i + 1] = m_cell_start[i] + m_cell_alive[i];
+    m_cell_points.assign(m_num_alive, 0);
+    std::vector<size_t> cell_end(m_cell_start.begin(), m_cell_start.end() - 1);
+    for (size_t i = 0; i < m_points.size(); ++ i)
+        if (! m_removed[i / m_ends_per_item])
+            m_cell_points[cell_end[this->cell_y(m_points[i](1)) * m_cols + this->cell_x(m_points[i](0))] ++] = i;
+}
+
+// Cell of a coordinate, the points outside of the grid are clamped to its border cells.
+size_t ClosestEndPointIndex::cell_x(coord_t x) const
+{
+    int64_t c = (int64_t(x) - int64_t(m_origin(0))) / m_cell_size;
+    return size_t(std::max<int64_t>(0, std::min<int64_t>(c, int64_t(m_cols) - 1)));
+}
+
+size_t ClosestEndPointIndex::cell_y(coord_t y) const
+{
+    int64_t c = (int64_t(y) - int64_t(m_origin(1))) / m_cell_size;
+    return size_t(std::max<int64_t>(0, std::min<int64_t>(c, int64_t(m_rows) - 1)));
+}
+
+// Is the end point idx at the squared distance d closer than the best one found so far?
+inline bool ClosestEndPointIndex::closer(double d, size_t idx, double d_best, size_t idx_best) const
+{
+    if (d != d_best)
+        return d < d_best;
+    // The squared distance of two integer points is zero or at least one.
+    return (m_tie_break == tbFirst || d < EPSILON) ? idx < idx_best : idx > idx_best;
+}
+
+size_t ClosestEndPointIndex::closest(const Point &pt) const
+{
+    size_t idx_best = size_t(-1);
+    double d_best   = std::numeric_limits<double>::max();
+    if (m_num_alive == 0)
+        return idx_best;
+
+    const int64_t cx = int64_t(this->cell_x(pt(0)));
+    const int64_t cy = int64_t(this->cell_y(pt(1)));
+    const int64_t cols = int64_t(m_cols);
+    const int64_t rows = int64_t(m_rows);
+    auto search_cell = [this, &pt, &idx_best, &d_best](size_t cell) {
+        if (m_cell_alive[cell] == 0)
+            return;
+        for (size_t i = m_cell_start[cell]; i < m_cell_start[cell + 1]; ++ i) {
+            size_t idx = m_cell_points[i];
+            if (m_removed[idx / m_ends_per_item])
+                continue;
+            const Point &p = m_points[idx];
+            // The same expression as Point::nearest_point_index(), the ties are decided on the rounded distances.
+            double d = sqr<double>(pt(0) - p(0)) + sqr<double>(pt(1) - p(1));
+            if (this->closer(d, idx, d_best, idx_best)) {
+                d_best   = d;
+                idx_best = idx;
+            }
+        }
+    };
+
+    // Search the rings of cells around the cell of pt.
+    for (int64_t k = 0;; ++ k) {
+        if (k > 0) {
+            // The square of cells [cx - k + 1, cx + k - 1] x [cy - k + 1, cy + k - 1] was searched.
+            int64_t xl = cx - k + 1, xh = cx + k - 1, yl = cy - k + 1, yh = cy + k - 1;
+            if (xl <= 0 && yl <= 0 && xh >= cols - 1 && yh >= rows - 1)
+                break;
+            if (idx_best != size_t(-1)) {
+                // Any end point outside of the square is at least gap away along x or y. The rounding to double
+                // is monotonic, so such a point cannot be closer or tied with the best point if gap^2 > d_best.
+                // There are no end points beyond the border of the grid.
+                int64_t gap = std::numeric_limits<int64_t>::max();
+                if (xl > 0)
+                    gap = std::min(gap, int64_t(pt(0)) - (int64_t(m_origin(0)) + xl * m_cell_size));
+                if (xh < cols - 1)
+                    gap = std::min(gap, int64_t(m_origin(0)) + (xh + 1) * m_cell_size - int64_t(pt(0)));
+                if (yl > 0)
+                    gap = std::min(gap, int64_t(pt(1)) - (int64_t(m_origin(1)) + yl * m_cell_size));
+                if (yh < rows - 1)
+                    gap = std::min(gap, int64_t(m_origin(1)) + (yh + 1) * m_cell_size - int64_t(pt(1)));
+                gap = std::max<int64_t>(gap, 0);
+                if (sqr<double>(double(gap)) > d_best)
+                    break;
+            }
+        }
+        for (int64_t y = std::max<int64_t>(cy - k, 0); y <= std::min(cy + k, rows - 1); ++ y) {
+            size_t row = size_t(y) * m_cols;
+            if (y == cy - k || y == cy + k) {
+                for (int64_t x = std::max<int64_t>(cx - k, 0); x <= std::min(cx + k, cols - 1); ++ x)
+                    search_cell(row + size_t(x));
+            } else {
+                if (cx - k >= 0)
+                    search_cell(row + size_t(cx - k));
+                if (cx + k < cols)
+                    search_cell(row + size_t(cx + k));
+            }
+        }
+    }
+    return idx_best;
+}
+
+void ClosestEndPointIndex::remove_item(size_t item)
+{
+    assert(! m_removed[item]);
+    m_removed[item] = true;
+    for (size_t i = 0; i < m_ends_per_item; ++ i) {
+        const Point &p = m_points[item * m_ends_per_item + i];
+        -- m_cell_alive[this->cell_y(p(1)) * m_cols + this->cell_x(p(0))];
+    }
+    m_num_alive -= m_ends_per_item;
+    // Once most of the grid is emptied by the walk, the rings of cells to search for the closest point grow.
+    // Rebuilding the grid over the remaining end points costs O(N) in total.
+    if (m_num_alive * 2 < m_num_indexed)
+        this->build_grid();
+}
+
+} // namespace Slic3r
@@ -0,0 +1,69 @@
+#ifndef slic3r_ShortestPath_hpp_
+#define slic3r_ShortestPath_hpp_
+
+#include "libslic3r.h"
+#include "Point.hpp"
+
+#include <vector>
+
+namespace Slic3r {
+
+// Spatial index of the end points of items (points, polylines, extrusions) to be ordered by a nearest neighbor walk:
+// Start at a point, take the item with the end point closest to it, continue from the exit point of that item.
+// The end points are binned into a regular grid, the items already taken are marked as removed and the grid
+// is rebuilt over the remaining end points once half of them are gone, so that the search does not slow down
+// when the walk has emptied most of the grid. Ordering N items takes roughly O(N log N) instead of O(N^2)
+// of the linear search.
+class ClosestEndPointIndex
+{
+public:
+    // How to choose between the end points at the same distance. Each of the chaining functions used to search
+    // the end points linearly and broke the ties in its own way, the order of the extrusions and therefore
+    // the G-code depends on it.
+    enum TieBreak {
+        // The first end point in the order of end_points, as PolylineCollection::chained_path() picked.
+        tbFirst,
+        // The last end point in the order of end_points, unless an end point coincides with the query point,
+        // then the first such end point. This is what Point::nearest_point_index() returns.
+        tbLastUnlessCoincident,
+    };
+
+    // end_points[item * ends_per_item + i] is the i-th end point of the item, ends_per_item is 1 or 2.
+    ClosestEndPointIndex(const Points &end_points, size_t ends_per_item, TieBreak tie_break);
+
+    // Index into end_points of the end point closest to pt, not considering the removed items.
+    // Returns size_t(-1) if all the items were removed.
+    size_t closest(const Point &pt) const;
+    // Mark the item as taken, its end points will not be returned by closest() anymore.
+    void   remove_item(size_t item);
+    size_t num_items_left() const { return m_num_alive / m_ends_per_item; }
+
+private:
+    // Bin the end points of the items not removed yet into a grid.
+    void   build_grid();
+    size_t cell_x(coord_t x) const;
+    size_t cell_y(coord_t y) const;
+    bool   closer(double d, size_t idx, double d_best, size_t idx_best) const;
+
+    Points              m_points;
+    size_t              m_ends_per_item;
+    TieBreak            m_tie_break;
+    std::vector<char>   m_removed;
+    size_t              m_num_alive;
+
+    // The grid, rebuilt by build_grid().
+    Point               m_origin;
+    coord_t             m_cell_size;
+    size_t              m_cols;
+    size_t              m_rows;
+    size_t              m_num_indexed;
+    // End points of the cell i are m_cell_points[m_cell_start[i] .. m_cell_start[i + 1]), including the removed ones.
+    std::vector<size_t> m_cell_start;
+    std::vector<size_t> m_cell_points;
+    // Number of the end points of the cell, which were not removed yet, to skip the emptied cells quickly.
+    std::vector<size_t> m_cell_alive;
+};
+
+} // namespace Slic3r
+
+#endif /* slic3r_ShortestPath_hpp_ */
@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <math.h>
 #include <type_traits>
+#include <limits>
 
 #include <boost/log/trivial.hpp>
 
@@ -78,8 +79,6 @@ TriangleMesh& TriangleMesh::operator=(const TriangleMesh &other)
     stl_close(&this->stl);
     this->stl       = other.stl;
     this->repaired  = other.repaired;
-    this->stl.heads = nullptr;
-    this->stl.tail  = nullptr;
     this->stl.error = other.stl.error;
     if (other.stl.facet_start != nullptr) {
         this->stl.facet_start = (stl_facet*)calloc(other.stl.stats.number_of_facets, sizeof(stl_facet));
@@ -630,6 +629,9 @@ void TriangleMesh::require_shared_vertices()
     BOOST_LOG_TRIVIAL(trace) << "TriangleMeshSlicer::require_shared_vertices - end";
 }
 
+// Number of facets sharing a single leaf of TriangleMeshSlicer::facets_z_max_tree.
+static const size_t FACETS_Z_BLOCK_SIZE = 16;
+
 void TriangleMeshSlicer::init(TriangleMesh *_mesh, throw_on_cancel_callback_type throw_on_cancel)
 {
     mesh = _mesh;
@@ -714,6 +716,66 @@ void TriangleMeshSlicer::init(TriangleMesh *_mesh, throw_on_cancel_callback_type
         if ((i & 0x0ffff) == 0)
             throw_on_cancel();
     }
+    throw_on_cancel();
+
+    // Index the facets by their z span.
+    this->facets_z_sorted.assign(this->mesh->stl.stats.number_of_facets, FacetZSpan());
+    for (int facet_idx = 0; facet_idx < this->mesh->stl.stats.number_of_facets; ++ facet_idx) {
+        const stl_facet &facet = this->mesh->stl.facet_start[facet_idx];
+        FacetZSpan      &span  = this->facets_z_sorted[facet_idx];
+        span.min_z     = fminf(facet.vertex[0](2), fminf(facet.vertex[1](2), facet.vertex[2](2)));
+        span.max_z     = fmaxf(facet.vertex[0](2), fmaxf(facet.vertex[1](2), facet.vertex[2](2)));
+        span.facet_idx = facet_idx;
+    }
+    std::sort(this->facets_z_sorted.begin(), this->facets_z_sorted.end(), 
+        [](const FacetZSpan &s1, const FacetZSpan &s2) { return s1.min_z < s2.min_z || (s1.min_z == s2.min_z && s1.facet_idx < s2.facet_idx); });
+    size_t num_blocks = (this->facets_z_sorted.size() + FACETS_Z_BLOCK_SIZE - 1) / FACETS_Z_BLOCK_SIZE;
+    size_t num_leaves = 1;
+    while (num_leaves < num_blocks)
+        num_leaves <<= 1;
+    this->facets_z_max_tree.assign(num_leaves * 2, - std::numeric_limits<float>::max());
+    for (size_t i = 0; i < this->facets_z_sorted.size(); ++ i) {
+        float &max_z = this->facets_z_max_tree[num_leaves + i / FACETS_Z_BLOCK_SIZE];
+        max_z = std::max(max_z, this->facets_z_sorted[i].max_z);
+    }
+    for (size_t i = num_leaves - 1; i > 0; -- i)
+        this->facets_z_max_tree[i] = std::max(this->facets_z_max_tree[i * 2], this->facets_z_max_tree[i * 2 + 1]);
+}
+
+// Collect indices of facets, whose z span intersects <min_z, max_z>, sorted by the facet index.
+void TriangleMeshSlicer::facets_in_z_range(float min_z, float max_z, std::vector<int> &facets) const
+{
+    facets.clear();
+    if (this->facets_z_sorted.empty())
+        return;
+    // Facets starting above max_z are at the end of facets_z_sorted.
+    size_t end = std::upper_bound(this->facets_z_sorted.begin(), this->facets_z_sorted.end(), max_z,
+        [](float z, const FacetZSpan &span) { return z < span.min_z; }) - this->facets_z_sorted.begin();
+    // Depth first traversal of the tree, skipping the subtrees of facets ending below min_z.
+    struct Node {
+        size_t idx;
+        // Range of blocks covered by this node.
+        size_t block_begin;
+        size_t num_blocks;
+    };
+    size_t            num_leaves = this->facets_z_max_tree.size() / 2;
+    std::vector<Node> stack { { 1, 0, num_leaves } };
+    while (! stack.empty()) {
+        Node node = stack.back();
+        stack.pop_back();
+        if (node.block_begin * FACETS_Z_BLOCK_SIZE >= end || this->facets_z_max_tree[node.idx] < min_z)
+            continue;
+        if (node.num_blocks == 1) {
+            for (size_t i = node.block_begin * FACETS_Z_BLOCK_SIZE; i < std::min(end, (node.block_begin + 1) * FACETS_Z_BLOCK_SIZE); ++ i)
+                if (this->facets_z_sorted[i].max_z >= min_z)
+                    facets.emplace_back(this->facets_z_sorted[i].facet_idx);
+        } else {
+            size_t half = node.num_blocks / 2;
+            stack.push_back({ node.idx * 2 + 1, node.block_begin + half, half });
+            stack.push_back({ node.idx * 2,     node.block_begin,        half });
+        }
+    }
+    std::sort(facets.begin(), facets.end());
 }
 
 void TriangleMeshSlicer::slice(const std::vector<float> &z, std::vector<Polygons>* layers, throw_on_cancel_callback_type throw_on_cancel) const
@@ -748,20 +810,84 @@ void TriangleMeshSlicer::slice(const std::vector<float> &z, std::vector<Polygons
     */
     
     BOOST_LOG_TRIVIAL(debug) << "TriangleMeshSlicer::_slice_do";
-    std::vector<IntersectionLines> lines(z.size());
-    {
-        boost::mutex lines_mutex;
-        tbb::parallel_for(
-            tbb::blocked_range<int>(0,this->mesh->stl.stats.number_of_facets),
-            [&lines, &lines_mutex, &z, throw_on_cancel, this](const tbb::blocked_range<int>& range) {
-                for (int facet_idx = range.begin(); facet_idx < range.end(); ++ facet_idx) {
-                    if ((facet_idx & 0x0ffff) == 0)
+    // The facets are sliced in blocks of a fixed size. Each block collects its intersection lines into its own buffer,
+    // therefore the slicing threads do not contend for a lock. The blocks are then merged per layer in the order of the facets,
+    // so the order of the intersection lines (and thus the output of make_loops()) does not depend on thread scheduling.
+    // If the slicing planes do not span the whole mesh, only the facets intersecting their range are sliced.
+    bool             slice_all = ! this->facets_z_sorted.empty() && ! z.empty() && 
+        z.front() <= this->facets_z_sorted.front().min_z && z.back() >= this->facets_z_max_tree[1];
+    std::vector<int> facets_in_range;
+    if (! slice_all && ! z.empty())
+        this->facets_in_z_range(z.front(), z.back(), facets_in_range);
+    const size_t num_facets = slice_all ? size_t(this->mesh->stl.stats.number_of_facets) : facets_in_range.size();
+    const size_t facets_per_block = 4096;
+    std::vector<std::vector<LayerIntersectionLine>> blocks((num_facets + facets_per_block - 1) / facets_per_block);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, blocks.size()),
+        [&blocks, &z, slice_all, &facets_in_range, num_facets, facets_per_block, throw_on_cancel, this](const tbb::blocked_range<size_t>& range) {
+            for (size_t block_idx = range.begin(); block_idx < range.end(); ++ block_idx) {
+                std::vector<LayerIntersectionLine> &block = blocks[block_idx];
+                size_t i_end = std::min(num_facets, (block_idx + 1) * facets_per_block);
+                for (size_t i = block_idx * facets_per_block; i < i_end; ++ i) {
+                    if ((i & 0x0ffff) == 0)
                         throw_on_cancel();
-                    this->_slice_do(facet_idx, &lines, &lines_mutex, z);
+                    this->_slice_do(slice_all ? i : size_t(facets_in_range[i]), &block, z);
+                }
+                if (block.empty())
+                    continue;
+                // Group the lines by layers with a counting sort, keep the order of facets inside a layer.
+                size_t layer_min = block.front().first;
+                size_t layer_max = layer_min;
+                for (const LayerIntersectionLine &l : block) {
+                    layer_min = std::min(layer_min, l.first);
+                    layer_max = std::max(layer_max, l.first);
                 }
+                std::vector<size_t> offsets(layer_max - layer_min + 2, 0);
+                for (const LayerIntersectionLine &l : block)
+                    ++ offsets[l.first - layer_min + 1];
+                for (size_t i = 1; i < offsets.size(); ++ i)
+                    offsets[i] += offsets[i - 1];
+                std::vector<LayerIntersectionLine> sorted(block.size());
+                for (const LayerIntersectionLine &l : block)
+                    sorted[offsets[l.first - layer_min] ++] = l;
+                block = std::move(sorted);
             }
-        );
-    }
+        }
+    );
+    throw_on_cancel();
+
+    BOOST_LOG_TRIVIAL(debug) << "TriangleMeshSlicer::_slice_do - merge";
+    std::vector<IntersectionLines> lines(z.size());
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, z.size()),
+        [&lines, &blocks, throw_on_cancel](const tbb::blocked_range<size_t>& range) {
+            auto layer_lower = [](const LayerIntersectionLine &l, size_t layer_idx) { return l.first < layer_idx; };
+            for (size_t layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
+                if ((layer_idx & 0x0ffff) == 0)
+                    throw_on_cancel();
+                // Count the lines first to allocate the layer at once.
+                std::vector<std::pair<const LayerIntersectionLine*, const LayerIntersectionLine*>> spans;
+                size_t num_lines = 0;
+                for (const std::vector<LayerIntersectionLine> &block : blocks) {
+                    const LayerIntersectionLine *begin = block.data() + (std::lower_bound(block.begin(), block.end(), layer_idx, layer_lower) - block.begin());
+                    const LayerIntersectionLine *end   = begin;
+                    for (const LayerIntersectionLine *block_end = block.data() + block.size(); end != block_end && end->first == layer_idx; ++ end) ;
+                    if (begin != end) {
+                        spans.emplace_back(begin, end);
+                        num_lines += end - begin;
+                    }
+                }
+                IntersectionLines &layer_lines = lines[layer_idx];
+                layer_lines.reserve(num_lines);
+                for (const std::pair<const LayerIntersectionLine*, const LayerIntersectionLine*> &span : spans)
+                    for (const LayerIntersectionLine *l = span.first; l != span.second; ++ l)
+                        layer_lines.emplace_back(l->second);
+            }
+        }
+    );
+    // Release the per block buffers before the loops are built.
+    blocks.clear();
+    blocks.shrink_to_fit();
     throw_on_cancel();
 
     // v_scaled_shared could be freed here
@@ -815,8 +941,7 @@ void TriangleMeshSlicer::slice(const std::vector<float> &z, std::vector<Polygons
 #endif
 }
 
-void TriangleMeshSlicer::_slice_do(size_t facet_idx, std::vector<IntersectionLines>* lines, boost::mutex* lines_mutex, 
-    const std::vector<float> &z) const
+void TriangleMeshSlicer::_slice_do(size_t facet_idx, std::vector<LayerIntersectionLine>* lines, const std::vector<float> &z) const
 {
     const stl_facet &facet = this->mesh->stl.facet_start[facet_idx];
     
@@ -844,11 +969,10 @@ void TriangleMeshSlicer::_slice_do(size_t facet_idx, std::vector<IntersectionLin
         std::vector<float>::size_type layer_idx = it - z.begin();
         IntersectionLine il;
         if (this->slice_facet(*it / SCALING_FACTOR, facet, facet_idx, min_z, max_z, &il) == TriangleMeshSlicer::Slicing) {
-            boost::lock_guard<boost::mutex> l(*lines_mutex);
             if (il.edge_type == feHorizontal) {
                 // Ignore horizontal triangles. Any valid horizontal triangle must have a vertical triangle connected, otherwise the part has zero volume.
             } else
-                (*lines)[layer_idx].emplace_back(il);
+                lines->emplace_back(layer_idx, il);
         }
     }
 }
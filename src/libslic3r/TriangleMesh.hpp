@@ -155,6 +155,8 @@ public:
 };
 typedef std::vector<IntersectionLine> IntersectionLines;
 typedef std::vector<IntersectionLine*> IntersectionLinePtrs;
+// Intersection line tagged with an index of the layer it belongs to.
+typedef std::pair<size_t, IntersectionLine> LayerIntersectionLine;
 
 class TriangleMeshSlicer
 {
@@ -164,6 +166,7 @@ public:
     // Not quite nice, but the constructor and init() methods require non-const mesh pointer to be able to call mesh->require_shared_vertices()
 	TriangleMeshSlicer(TriangleMesh* mesh) { this->init(mesh, [](){}); }
     void init(TriangleMesh *mesh, throw_on_cancel_callback_type throw_on_cancel);
+    // Only the facets intersecting the range <z.front(), z.back()> are visited, therefore slicing a narrow band of a large mesh is cheap.
     void slice(const std::vector<float> &z, std::vector<Polygons>* layers, throw_on_cancel_callback_type throw_on_cancel) const;
     void slice(const std::vector<float> &z, const float closing_radius, std::vector<ExPolygons>* layers, throw_on_cancel_callback_type throw_on_cancel) const;
     enum FacetSliceType {
@@ -181,8 +184,22 @@ private:
     std::vector<int>         facets_edges;
     // Scaled copy of this->mesh->stl.v_shared
     std::vector<stl_vertex>  v_scaled_shared;
+    // Z span of a facet, used to index the facets by z.
+    struct FacetZSpan {
+        float min_z;
+        float max_z;
+        int   facet_idx;
+    };
+    // Facets sorted by their minimum z, built by init().
+    std::vector<FacetZSpan>  facets_z_sorted;
+    // Implicit binary tree (root at index 1, leaves at the second half) of the maximum z
+    // of the blocks of facets_z_sorted. Together with facets_z_sorted it allows to find the facets
+    // intersecting a range of z values in a time proportional to the number of such facets.
+    std::vector<float>       facets_z_max_tree;
+
+    void facets_in_z_range(float min_z, float max_z, std::vector<int> &facets) const;
 
-    void _slice_do(size_t facet_idx, std::vector<IntersectionLines>* lines, boost::mutex* lines_mutex, const std::vector<float> &z) const;
+    void _slice_do(size_t facet_idx, std::vector<LayerIntersectionLine>* lines, const std::vector<float> &z) const;
     void make_loops(std::vector<IntersectionLine> &lines, Polygons* loops) const;
     void make_expolygons(const Polygons &loops, const float closing_radius, ExPolygons* slices) const;
     void make_expolygons_simple(std::vector<IntersectionLine> &lines, ExPolygons* slices) const;